@@ -9,6 +9,7 @@
 #include "nlohmann/json.hpp"
 #include "utils.hpp"
 
+#include <cassert>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -35,6 +36,13 @@ constexpr std::uint32_t COST_DIRECTION_REVERSE = 4 * COST_SINGLE_QUBIT_GATE;
 
 class Architecture {
 public:
+  /**
+   * type of the entries of the flat distance table; all costs are small
+   * integers (multiples of the gate costs above), which single precision
+   * represents exactly
+   */
+  using DistanceEntry = float;
+
   class Properties {
   protected:
     template <class KeyType, class ValueType> class Property {
@@ -238,13 +246,46 @@ public:
     createDistanceTable();
   }
 
-  CouplingMap& getCurrentTeleportations() { return currentTeleportations; }
+  [[nodiscard]] const CouplingMap& getCurrentTeleportations() const {
+    return currentTeleportations;
+  }
+  /**
+   * @brief sets the teleportation edges currently available in addition to
+   * the coupling map and switches `distance` to the corresponding distance
+   * table (which is computed once per set of teleportation edges and cached)
+   */
+  void setCurrentTeleportations(const CouplingMap& teleportations);
   std::vector<std::pair<std::int16_t, std::int16_t>>& getTeleportationQubits() {
     return teleportationQubits;
   }
 
   [[nodiscard]] const Matrix& getDistanceTable() const { return distanceTable; }
 
+  /**
+   * @brief returns true if the given edge is part of the coupling map (if
+   * `considerDirection` is false, the reverse edge is accepted as well)
+   *
+   * Uses a bit matrix of the coupling map built in `createDistanceTable`, i.e.
+   * runs in constant time.
+   */
+  [[nodiscard]] bool isEdgeConnected(const Edge& edge,
+                                     bool considerDirection = true) const {
+    if (edge.first >= nqubits || edge.second >= nqubits) {
+      return false;
+    }
+    return couplingBit(edge.first, edge.second) ||
+           (!considerDirection && couplingBit(edge.second, edge.first));
+  }
+
+  /**
+   * @brief returns all physical qubits connected to the given qubit on the
+   * architecture (in any direction) in ascending order
+   */
+  [[nodiscard]] const std::vector<std::uint16_t>&
+  getNeighbours(const std::uint16_t qubit) const {
+    return neighbours.at(qubit);
+  }
+
   [[nodiscard]] const Properties& getProperties() const { return properties; }
 
   [[nodiscard]] Properties& getProperties() { return properties; }
@@ -274,18 +315,46 @@ public:
     nqubits = 0;
     couplingMap.clear();
     distanceTable.clear();
+    couplingBits.clear();
+    couplingBitsRowSize = 0;
+    neighbours.clear();
+    currentTeleportations.clear();
+    teleportationDistanceTable.clear();
+    teleportationDistanceTables.clear();
+    flatDistanceTable.clear();
     isBidirectional = true;
     properties.clear();
     fidelityTable.clear();
     singleQubitFidelities.clear();
   }
 
-  [[nodiscard]] double distance(std::uint16_t control,
-                                std::uint16_t target) const {
-    if (currentTeleportations.empty()) {
-      return distanceTable.at(control).at(target);
-    }
-    return static_cast<double>(bfs(control, target, currentTeleportations));
+  /**
+   * @brief returns the cost of routing a gate from `control` to `target`
+   * according to the distance table currently in use (i.e., taking
+   * `currentTeleportations` into account)
+   *
+   * The qubits are not bounds checked.
+   */
+  [[nodiscard]] double distance(const std::uint16_t control,
+                                const std::uint16_t target) const {
+    assert(control < nqubits && target < nqubits);
+    return static_cast<double>(
+        flatDistanceTable[static_cast<std::size_t>(control) * nqubits +
+                          target]);
+  }
+
+  /**
+   * @brief returns a pointer to the `nqubits` contiguous distances from
+   * `control` to all physical qubits (see `distance`)
+   *
+   * The pointer is invalidated by any change of the coupling map or of the
+   * current teleportations.
+   */
+  [[nodiscard]] const DistanceEntry*
+  getDistanceRow(const std::uint16_t control) const {
+    assert(control < nqubits);
+    return flatDistanceTable.data() +
+           static_cast<std::size_t>(control) * nqubits;
   }
 
   [[nodiscard]] std::set<std::uint16_t> getQubitSet() const {
@@ -361,15 +430,48 @@ protected:
   Matrix                                             fidelityTable         = {};
   std::vector<double>                                singleQubitFidelities = {};
 
+  /** flat bit matrix of the coupling map (row `i` holds the targets of all
+   * edges starting in `i`) */
+  std::vector<std::uint64_t> couplingBits        = {};
+  std::size_t                couplingBitsRowSize = 0;
+  /** neighbours of each physical qubit (in any direction) */
+  std::vector<std::vector<std::uint16_t>> neighbours = {};
+
+  /** distance table for the coupling map extended by `currentTeleportations`
+   */
+  Matrix teleportationDistanceTable = {};
+  /** previously computed distance tables by set of teleportation edges */
+  std::map<CouplingMap, Matrix> teleportationDistanceTables = {};
+  /** maximum number of cached distance tables for teleportation edges */
+  static constexpr std::size_t MAX_TELEPORTATION_DISTANCE_TABLES = 64;
+  /**
+   * row-major copy of the distance table used by `distance` (either
+   * `distanceTable` or `teleportationDistanceTable`)
+   */
+  std::vector<DistanceEntry> flatDistanceTable = {};
+
   void createDistanceTable();
   void createFidelityTable();
-
-  // added for teleportation
-  static bool contains(const std::vector<int>& v, const int e) {
-    return std::find(v.begin(), v.end(), e) != v.end();
+  /**
+   * @brief copies the given distance table into `flatDistanceTable`
+   */
+  void flattenDistanceTable(const Matrix& table);
+  /**
+   * @brief computes the distances between all physical qubits if the given
+   * teleportations are available in addition to the coupling map
+   *
+   * Equivalent to a breadth-first search for each qubit pair that considers
+   * all edges undirected.
+   */
+  void createTeleportationDistanceTable(const CouplingMap& teleportations,
+                                        Matrix&            table) const;
+
+  [[nodiscard]] bool couplingBit(const std::uint16_t control,
+                                 const std::uint16_t target) const {
+    return ((couplingBits[control * couplingBitsRowSize + target / 64U] >>
+             (target % 64U)) &
+            1U) != 0U;
   }
-  [[nodiscard]] std::uint64_t bfs(std::uint16_t start, std::uint16_t goal,
-                                  const std::set<Edge>& teleportations) const;
 
   static std::size_t findCouplingLimit(const CouplingMap& cm,
                                        std::uint16_t      nQubits);
@@ -14,13 +14,29 @@
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 constexpr std::int16_t  DEFAULT_POSITION  = -1;
 constexpr double        INITIAL_FIDELITY  = 1.0;
-constexpr std::uint16_t MAX_DEVICE_QUBITS = 128;
+constexpr std::uint16_t MAX_DEVICE_QUBITS = 1024;
+
+/**
+ * number of two-qubit gates acting on pairs of logical qubits in some layer
+ * where the keys correspond to logical qubit pairs ({q1, q2}, with q1<=q2)
+ * and the values to the number of gates acting on a pair in each direction
+ * (the first number with control=q1, target=q2 and the second the reverse).
+ *
+ * e.g., with multiplicity {{0,1},{2,3}} there are 2 gates with logical
+ * qubit 0 as control and qubit 1 as target, and 3 gates with 1 as control
+ * and 0 as target.
+ */
+using TwoQubitMultiplicity =
+    std::map<Edge, std::pair<std::uint16_t, std::uint16_t>>;
 
 class Mapper {
 protected:
@@ -44,6 +60,119 @@ protected:
     [[nodiscard]] bool singleQubit() const { return control == -1; }
   };
 
+  /**
+   * @brief The gates of a circuit split into layers, stored contiguously
+   *
+   * All gates are kept in a single array ordered by layer (and by their
+   * position in the circuit within each layer), the gates of layer `i` being
+   * those between `offsets[i]` and `offsets[i + 1]`. The gates acting on two
+   * qubits are additionally stored in a second array of the same layout, and
+   * so are their multiplicities (aggregated by qubit pair and ordered like the
+   * entries of a `TwoQubitMultiplicity`).
+   */
+  class Layers {
+  public:
+    /**
+     * @brief The gates of one layer (only valid as long as the `Layers` they
+     * belong to are not modified)
+     */
+    class GateRange {
+    public:
+      GateRange(const Gate* first, const Gate* last)
+          : first(first), last(last) {}
+
+      [[nodiscard]] const Gate* begin() const { return first; }
+      [[nodiscard]] const Gate* end() const { return last; }
+      [[nodiscard]] std::size_t size() const {
+        return static_cast<std::size_t>(last - first);
+      }
+      [[nodiscard]] bool        empty() const { return first == last; }
+      [[nodiscard]] const Gate& operator[](const std::size_t idx) const {
+        return first[idx]; // NOLINT(cppcoreguidelines-pro-bounds-*)
+      }
+
+    private:
+      const Gate* first;
+      const Gate* last;
+    };
+
+    /**
+     * @brief Replaces the stored layers
+     *
+     * @param circuitGates all gates in the order of the circuit
+     * @param gateLayers the layer of each gate in `circuitGates`
+     * @param nlayers the number of layers (greater than all `gateLayers`)
+     */
+    void assign(std::vector<Gate>               circuitGates,
+                const std::vector<std::size_t>& gateLayers,
+                std::size_t                     nlayers);
+
+    void clear();
+
+    [[nodiscard]] std::size_t size() const { return offsets.size() - 1; }
+    [[nodiscard]] bool        empty() const { return size() == 0; }
+
+    /**
+     * @brief All gates of the given layer in the order of the circuit
+     */
+    [[nodiscard]] GateRange operator[](const std::size_t idx) const {
+      return {gates.data() + offsets[idx], gates.data() + offsets[idx + 1]};
+    }
+    [[nodiscard]] GateRange at(const std::size_t idx) const {
+      checkIndex(idx);
+      return (*this)[idx];
+    }
+
+    /**
+     * @brief The gates of the given layer acting on two qubits in the order of
+     * the circuit
+     */
+    [[nodiscard]] GateRange twoQubitGates(const std::size_t idx) const {
+      checkIndex(idx);
+      return {twoQubit.data() + twoQubitOffsets[idx],
+              twoQubit.data() + twoQubitOffsets[idx + 1]};
+    }
+
+    [[nodiscard]] bool hasTwoQubitGates(const std::size_t idx) const {
+      checkIndex(idx);
+      return twoQubitOffsets[idx] != twoQubitOffsets[idx + 1];
+    }
+
+    /**
+     * @brief The number of two-qubit gates acting on each pair of logical
+     * qubits in the given layer
+     */
+    [[nodiscard]] TwoQubitMultiplicity
+    twoQubitMultiplicity(const std::size_t idx) const {
+      checkIndex(idx);
+      TwoQubitMultiplicity multiplicity{};
+      for (auto i = multiplicityOffsets[idx]; i < multiplicityOffsets[idx + 1];
+           ++i) {
+        multiplicity.emplace_hint(multiplicity.end(), multiplicities[i]);
+      }
+      return multiplicity;
+    }
+
+  private:
+    std::vector<Gate>        gates{};
+    std::vector<std::size_t> offsets{0};
+    std::vector<Gate>        twoQubit{};
+    std::vector<std::size_t> twoQubitOffsets{0};
+
+    /** entry of a `TwoQubitMultiplicity` (with a non-const key) */
+    using MultiplicityEntry =
+        std::pair<Edge, std::pair<std::uint16_t, std::uint16_t>>;
+
+    std::vector<MultiplicityEntry> multiplicities{};
+    std::vector<std::size_t>       multiplicityOffsets{0};
+
+    void checkIndex(const std::size_t idx) const {
+      if (idx >= size()) {
+        throw std::out_of_range("Layer index out of range.");
+      }
+    }
+  };
+
   /**
    * @brief The quantum circuit to be mapped
    */
@@ -59,11 +188,17 @@ protected:
   qc::QuantumComputation qcMapped;
   /**
    * @brief The gates of the circuit split into layers
+   */
+  Layers layers{};
+  /**
+   * @brief Index of the first layer at or after each layer index containing a
+   * gate acting on more than one qubit
    *
-   * Each entry in the outer vector corresponds to 1 layer, containing all its
-   * gates in an inner vector
+   * Built by `createLayers` with one entry per layer plus a final entry for
+   * the end of the circuit; entries without such a layer hold
+   * `std::numeric_limits<std::size_t>::max()`
    */
-  std::vector<std::vector<Gate>> layers{};
+  std::vector<std::size_t> nextTwoQubitLayer{};
 
   /**
    * @brief containing the logical qubit currently mapped to each physical
@@ -111,6 +246,11 @@ protected:
    */
   virtual void createLayers();
 
+  /**
+   * @brief Fills `nextTwoQubitLayer` from the current `layers`
+   */
+  void createNextTwoQubitLayerIndex();
+
   /**
    * gates are put in the last layer (from the back of the circuit) in which
    * all of its qubits are not yet used by another gate in a circuit diagram
@@ -118,20 +258,23 @@ protected:
    * defining each column of gates as one layer.
    *
    * @param lastLayer the array storing the last layer each qubit is used in
+   * @param lastPartner the array storing for each qubit the other qubit of the
+   * last two-qubit gate it is used in (-1 if there is none)
    * @param control the (potential) control qubit of the gate
    * @param target the target qubit of the gate
-   * @param gate the gate to be added to the layer
    * @param collect2qBlocks if true, gates are collected in 2Q-blocks, and
    * layering is performed on these blocks
+   * @return the layer the gate is added to
    */
-  void processDisjointQubitLayer(
+  static std::size_t processDisjointQubitLayer(
       std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+      std::array<std::int16_t, MAX_DEVICE_QUBITS>&               lastPartner,
       const std::optional<std::uint16_t>& control, std::uint16_t target,
-      qc::Operation* gate, bool collect2qBlocks);
+      bool collect2qBlocks);
 
   /**
    * @brief Get the index of the next layer after the given index containing a
-   * gate acting on more than one qubit
+   * gate acting on more than one qubit (looked up in `nextTwoQubitLayer`)
    */
   [[gnu::pure]] virtual std::size_t getNextLayer(std::size_t idx);
 
@@ -182,6 +325,19 @@ protected:
    */
   virtual void postMappingOptimizations(const Configuration& config);
 
+  /**
+   * @brief tag selecting the constructor for circuits which have already been
+   * preprocessed by the constructor of another mapper
+   */
+  struct PreprocessedCircuit {};
+
+  /**
+   * @brief constructs a mapper without stripping idle qubits and final
+   * measurements from the circuit (which must already have been done)
+   */
+  Mapper(const qc::QuantumComputation& quantumComputation,
+         Architecture& architecture, PreprocessedCircuit /*tag*/);
+
 public:
   Mapper(const qc::QuantumComputation& quantumComputation,
          Architecture&                 architecture);
@@ -240,8 +396,8 @@ public:
 
   std::ostream& printLayering(std::ostream& out) {
     out << "---------------- Layering -------------------" << std::endl;
-    for (auto& layer : layers) {
-      for (auto& gate : layer) {
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+      for (const auto& gate : layers[i]) {
         if (gate.singleQubit()) {
           out << "(" << gate.target << ") ";
         } else {
@@ -277,6 +433,7 @@ public:
     architecture.reset();
     qc.reset();
     layers.clear();
+    nextTwoQubitLayer.clear();
     qubits.fill(DEFAULT_POSITION);
     locations.fill(DEFAULT_POSITION);
     usedDeviceQubits.clear();
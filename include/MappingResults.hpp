@@ -7,6 +7,7 @@
 #include "configuration/Configuration.hpp"
 
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -31,6 +32,10 @@ struct MappingResults {
   struct HeuristicBenchmarkInfo {
     std::size_t expandedNodes            = 0;
     std::size_t generatedNodes           = 0;
+    std::size_t prunedNodes              = 0;
+    std::size_t reExpandedNodes          = 0;
+    std::size_t layerCacheHits           = 0;
+    std::size_t layerCacheMisses         = 0;
     std::size_t solutionDepth            = 0;
     double      timePerNode              = 0.;
     double      averageBranchingFactor   = 0.;
@@ -44,6 +49,10 @@ struct MappingResults {
 
   double time    = 0.0;
   bool   timeout = true;
+  // upper bound on the ratio between the cost of the mapping of each layer and
+  // the optimal one (only determined by the anytime heuristic search with an
+  // admissible heuristic and without lookahead, `std::nullopt` otherwise)
+  std::optional<double> suboptimalityBound{};
 
   CircuitInfo output{};
   std::string mappedCircuit{};
@@ -102,15 +111,26 @@ struct MappingResults {
         stats["WCNF"] = wcnf;
       }
     } else if (config.method == Method::Heuristic) {
-      stats["teleportations"]      = output.teleportations;
-      auto& benchmark              = stats["benchmark"];
-      benchmark["expanded_nodes"]  = heuristicBenchmark.expandedNodes;
-      benchmark["generated_nodes"] = heuristicBenchmark.generatedNodes;
-      benchmark["time_per_node"]   = heuristicBenchmark.timePerNode;
+      stats["teleportations"]       = output.teleportations;
+      auto& benchmark               = stats["benchmark"];
+      benchmark["expanded_nodes"]   = heuristicBenchmark.expandedNodes;
+      benchmark["generated_nodes"]  = heuristicBenchmark.generatedNodes;
+      benchmark["pruned_nodes"]     = heuristicBenchmark.prunedNodes;
+      benchmark["reexpanded_nodes"] = heuristicBenchmark.reExpandedNodes;
+      benchmark["time_per_node"]    = heuristicBenchmark.timePerNode;
       benchmark["average_branching_factor"] =
           heuristicBenchmark.averageBranchingFactor;
       benchmark["effective_branching_factor"] =
           heuristicBenchmark.effectiveBranchingFactor;
+      if (config.cacheLayerSolutions) {
+        benchmark["layer_cache_hits"]   = heuristicBenchmark.layerCacheHits;
+        benchmark["layer_cache_misses"] = heuristicBenchmark.layerCacheMisses;
+      }
+      if (config.searchAlgorithm == SearchAlgorithm::AnytimeAStar) {
+        stats["suboptimality_bound"] =
+            suboptimalityBound.has_value() ? nlohmann::json(*suboptimalityBound)
+                                           : nlohmann::json(nullptr);
+      }
     }
     stats["additional_gates"] =
         static_cast<std::make_signed_t<decltype(output.gates)>>(output.gates) -
@@ -10,10 +10,12 @@
 #include "InitialLayout.hpp"
 #include "Layering.hpp"
 #include "Method.hpp"
+#include "SearchAlgorithm.hpp"
 #include "SwapReduction.hpp"
 #include "nlohmann/json.hpp"
 
 #include <set>
+#include <string>
 
 struct Configuration {
   Configuration() = default;
@@ -46,13 +48,74 @@ struct Configuration {
   double      firstLookaheadFactor = 0.75;
   double      lookaheadFactor      = 0.5;
 
+  // search algorithm of the heuristic mapper
+  SearchAlgorithm searchAlgorithm = SearchAlgorithm::AStar;
+
+  // number of threads used by the heuristic mapper, either to evaluate the
+  // children of a search node (A*, results do not depend on this setting) or
+  // as search threads (HDA*)
+  std::size_t nThreads = 1;
+
+  // maximum number of bytes used by the open list(s) of the heuristic mapper
+  // (0 = unlimited); once exceeded, the worst nodes are dropped, so that the
+  // search may no longer find an optimal solution (if it does not reach a goal
+  // soon afterwards, the layer is mapped by IDA* instead; for IDA* this is the
+  // size of the transposition table, which does not affect optimality)
+  std::size_t memoryLimit = 0;
+
+  // if true, the heuristic mapper considers only one order of two consecutive
+  // swaps on disjoint (i.e., commuting) edges; with the admissible heuristic
+  // and without lookahead the cost of each layer stays optimal, with lookahead
+  // it may increase, since the pruned order may pass a node with a lower
+  // lookahead penalty
+  bool pruneCommutingSwaps = false;
+
+  // if true (and `admissibleHeuristic` is set), the heuristic mapper
+  // additionally bounds the number of swaps needed for all gates of a layer
+  // jointly (every swap moves only two qubits, so disjoint qubit pairs far
+  // apart need separate swaps), which is still admissible but usually much
+  // tighter than the maximum distance of a single pair
+  bool swapCountBound = false;
+
+  // if true (and `admissibleHeuristic` is set), the swap count bound is
+  // computed from the exact swap counts of single and two gate pairs stored in
+  // a pattern database of the architecture (see `PatternDatabase`); if
+  // `patternDatabaseDirectory` is set, the database is loaded from this
+  // directory or stored there after it has been built
+  bool        usePatternDatabase       = false;
+  std::string patternDatabaseDirectory = {};
+
+  // if true, the heuristic mapper stores the swaps found for each layer and
+  // replays them instead of searching whenever the same layer (with respect to
+  // the physical qubits of its gates and of the gates in the lookahead layers)
+  // has to be mapped again, also in later mapping runs of the same mapper (or
+  // of mappers sharing the cache, see `HeuristicMapper::setLayerCache`); not
+  // used with teleportation. Solutions of searches cut short by `memoryLimit`
+  // or by a time budget of the anytime search are not stored. With the
+  // admissible heuristic, replayed layers are as expensive as searched ones,
+  // but ties between equally expensive solutions may be broken differently
+  bool cacheLayerSolutions = false;
+
+  // anytime search settings: the weight of the heuristic starts at
+  // `heuristicWeight` and is decreased by `heuristicWeightDecrease` (down to 1)
+  // after each mapping found for a layer, until the time budget of the layer
+  // (`layerTimeout` in ms, 0 = unlimited) or of the mapping (`timeout`) is
+  // exhausted. The ratio of the cost of each mapping found and a lower bound of
+  // the optimal cost is only reported (`MappingResults::suboptimalityBound`)
+  // with `admissibleHeuristic` and without `lookahead`, since otherwise the
+  // costs of the search do not bound the optimal one
+  double      heuristicWeight         = 2.;
+  double      heuristicWeightDecrease = 0.5;
+  std::size_t layerTimeout            = 0;
+
   // teleportation settings
   bool          useTeleportation    = false;
   std::size_t   teleportationQubits = 0;
   std::uint64_t teleportationSeed   = 0;
   bool          teleportationFake   = false;
 
-  // timeout merely affects exact mapper
+  // timeout of the exact mapper and time budget of the whole mapping for the
+  // anytime search of the heuristic mapper (in ms)
   std::size_t timeout = 3600000; // 60min timeout
 
   // encoding of at most and exactly one constraints in exact mapper
@@ -0,0 +1,57 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#pragma once
+
+#include <iostream>
+
+/// AStar: sequential A*-search
+/// HDAStar: hash-distributed A*-search on `Configuration::nThreads` threads,
+/// each owning the search nodes whose mapping hashes to it
+/// IDAStar: iterative-deepening A*-search, only keeping the current path and a
+/// transposition table of bounded size in memory
+/// AnytimeAStar: weighted A*-search restarted with decreasing weights, which
+/// returns the best mapping found once its time budget is exhausted
+/// PEAStar: partial-expansion A*-search, only adding the children of a node
+/// with the lowest cost to the open list and re-adding the node itself with
+/// the cost of its next best children
+enum class SearchAlgorithm { AStar, HDAStar, IDAStar, AnytimeAStar, PEAStar };
+
+[[maybe_unused]] static inline std::string
+toString(const SearchAlgorithm algorithm) {
+  switch (algorithm) {
+  case SearchAlgorithm::AStar:
+    return "a_star";
+  case SearchAlgorithm::HDAStar:
+    return "hda_star";
+  case SearchAlgorithm::IDAStar:
+    return "ida_star";
+  case SearchAlgorithm::AnytimeAStar:
+    return "anytime_a_star";
+  case SearchAlgorithm::PEAStar:
+    return "pea_star";
+  }
+  return " ";
+}
+
+[[maybe_unused]] static SearchAlgorithm
+searchAlgorithmFromString(const std::string& algorithm) {
+  if (algorithm == "a_star" || algorithm == "0") {
+    return SearchAlgorithm::AStar;
+  }
+  if (algorithm == "hda_star" || algorithm == "1") {
+    return SearchAlgorithm::HDAStar;
+  }
+  if (algorithm == "ida_star" || algorithm == "2") {
+    return SearchAlgorithm::IDAStar;
+  }
+  if (algorithm == "anytime_a_star" || algorithm == "3") {
+    return SearchAlgorithm::AnytimeAStar;
+  }
+  if (algorithm == "pea_star" || algorithm == "4") {
+    return SearchAlgorithm::PEAStar;
+  }
+  throw std::invalid_argument("Invalid search algorithm value: " + algorithm);
+}
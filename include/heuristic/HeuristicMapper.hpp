@@ -4,30 +4,82 @@
 //
 
 #include "Mapper.hpp"
-#include "heuristic/UniquePriorityQueue.hpp"
+#include "heuristic/IndexedPriorityQueue.hpp"
+#include "heuristic/LayerCache.hpp"
+#include "heuristic/PatternDatabase.hpp"
+#include "heuristic/SearchArena.hpp"
+#include "heuristic/SwapScoreBatch.hpp"
+#include "heuristic/WorkerPool.hpp"
 
+#include <chrono>
 #include <cmath>
+#include <memory>
+#include <optional>
 
 #pragma once
 
 /**
- * number of two-qubit gates acting on pairs of logical qubits in some layer
- * where the keys correspond to logical qubit pairs ({q1, q2}, with q1<=q2)
- * and the values to the number of gates acting on a pair in each direction
- * (the first number with control=q1, target=q2 and the second the reverse).
- *
- * e.g., with multiplicity {{0,1},{2,3}} there are 2 gates with logical
- * qubit 0 as control and qubit 1 as target, and 3 gates with 1 as control
- * and 0 as target.
+ * for each logical qubit the entries of a `TwoQubitMultiplicity` whose qubit
+ * pair contains this qubit (pointing into the multiplicity map, i.e. only valid
+ * as long as the map is not modified); qubits beyond the end of the index are
+ * not contained in any pair
  */
-using TwoQubitMultiplicity =
-    std::map<Edge, std::pair<std::uint16_t, std::uint16_t>>;
+using TwoQubitMultiplicityIndex =
+    std::vector<std::vector<const TwoQubitMultiplicity::value_type*>>;
+
+class HeuristicMapper;
+
+/**
+ * Heuristic mapper whose search nodes hold the mapping of up to `Capacity`
+ * physical qubits in fixed-size arrays, so that nodes for small architectures
+ * stay small. Instantiated for the capacities in
+ * `HeuristicMapper::NODE_CAPACITIES`, which selects one of them based on the
+ * number of qubits of the architecture.
+ */
+template <std::uint16_t Capacity>
+class BasicHeuristicMapper : public Mapper {
+  static_assert(Capacity <= MAX_DEVICE_QUBITS,
+                "capacity exceeds the maximum number of device qubits");
+  friend class HeuristicMapper;
 
-class HeuristicMapper : public Mapper {
 public:
   using Mapper::Mapper; // import constructors from parent class
 
   static constexpr double EFFECTIVE_BRANCH_RATE_TOLERANCE = 1e-10;
+  /**
+   * fraction of `Configuration::memoryLimit` an open list is pruned to once it
+   * exceeds the limit
+   */
+  static constexpr double MEMORY_LIMIT_PRUNE_TARGET = 0.75;
+  /**
+   * fraction of `Configuration::memoryLimit` the closed set of the A*-search
+   * may use before it is cleared
+   */
+  static constexpr double MEMORY_LIMIT_CLOSED_SET_SHARE = 0.25;
+  /**
+   * number of further expansions per node kept by the first pruning of an
+   * open list, after which a search is abandoned (see
+   * `BasicHeuristicMapper::memoryLimitExpansionBound`)
+   */
+  static constexpr std::size_t MEMORY_LIMIT_FALLBACK_FACTOR = 16;
+  /**
+   * number of entries of the IDA* transposition table if no
+   * `Configuration::memoryLimit` is set
+   */
+  static constexpr std::size_t DEFAULT_TRANSPOSITION_TABLE_SIZE = 1U << 20U;
+  /**
+   * tolerance when comparing costs against the bound of an IDA* iteration
+   */
+  static constexpr double IDA_STAR_BOUND_TOLERANCE = 1e-6;
+  /**
+   * tolerance when comparing costs against the incumbent of the anytime search
+   */
+  static constexpr double ANYTIME_COST_TOLERANCE = 1e-6;
+  /**
+   * tolerance when comparing costs of children against the stored cost of a
+   * node in partial-expansion A*
+   */
+  static constexpr double PARTIAL_EXPANSION_COST_TOLERANCE = 1e-6;
 
   /**
    * @brief map the circuit passed at initialization to the architecture
@@ -37,6 +89,33 @@ public:
    */
   void map(const Configuration& configuration) override;
 
+  /**
+   * @brief immutable record of one swap in the sequence of swaps leading to a
+   * search node, linked to the record of the preceding swap
+   *
+   * Records are shared between all search nodes descending from the same node,
+   * so that a child node never needs to copy the swaps of its ancestors.
+   */
+  struct SwapChain {
+    /** record of the preceding swap (`nullptr` for the first swap) */
+    std::shared_ptr<const SwapChain> previous;
+    /** the swap (or teleportation) itself */
+    Exchange swap;
+  };
+
+  /**
+   * @brief heuristic cost of the child of a search node for one candidate swap
+   * as computed by `Node::scoreSwaps`
+   */
+  struct SwapScore {
+    /** `Node::costHeur` of the child */
+    double costHeur = 0.;
+    /** `Node::nonAdjacentPairs` of the child */
+    std::size_t nonAdjacentPairs = 0;
+    /** false if the cost of the child has to be recalculated from scratch */
+    bool valid = false;
+  };
+
   /**
    * @brief struct representing one node in the A* search containing info about
    * swaps, mappings and costs
@@ -51,26 +130,40 @@ public:
     /** heuristic cost expected for future swaps needed in later circuit layers
      * (further layers contribute less) */
     double lookaheadPenalty = 0.;
+    /** lowest total cost of the children of this node which have not been
+     * added to the open list yet by partial-expansion A* (0 if the node has not
+     * been expanded) */
+    double nextChildCost = 0.;
     /**
      * containing the logical qubit currently mapped to each physical qubit.
      * `qubits[physical_qubit] = logical_qubit`
      *
      * The inverse of `locations`
      */
-    std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits{};
+    std::array<std::int16_t, Capacity> qubits{};
     /**
      * containing the logical qubit currently mapped to each physical qubit.
      * `locations[logical_qubit] = physical_qubit`
      *
      * The inverse of `qubits`
      */
-    std::array<std::int16_t, MAX_DEVICE_QUBITS> locations{};
+    std::array<std::int16_t, Capacity> locations{};
+    /** Zobrist hash of `qubits` (updated incrementally when applying swaps or
+     * teleportations) */
+    std::uint64_t hash = 0;
     /** true if all qubit pairs are mapped next to each other on the
      * architecture */
     bool done = true;
-    /** swaps used to get from mapping after last layer to the current mapping;
-     * each search node begins a new entry in the outer vector */
-    std::vector<std::vector<Exchange>> swaps = {};
+    /** number of logical qubit pairs sharing a gate in the current layer which
+     * are not mapped next to each other on the architecture */
+    std::size_t nonAdjacentPairs = 0;
+    /** swaps used to get from mapping after last layer to the mapping of the
+     * parent node; shared with all other nodes descending from the parent */
+    std::shared_ptr<const SwapChain> previousSwaps = nullptr;
+    /** swap used to get from the mapping of the parent node to the current
+     * mapping; stored inline so that creating a child node does not need any
+     * allocation */
+    std::optional<Exchange> lastSwap = std::nullopt;
     /** number of swaps used to get from mapping after last layer to the current
      * mapping */
     std::size_t nswaps = 0;
@@ -78,14 +171,83 @@ public:
     std::size_t depth = 0;
 
     Node() = default;
-    Node(const std::array<std::int16_t, MAX_DEVICE_QUBITS>& q,
-         const std::array<std::int16_t, MAX_DEVICE_QUBITS>& loc,
-         const std::vector<std::vector<Exchange>>&          sw = {},
+    Node(const std::array<std::int16_t, Capacity>& q,
+         const std::array<std::int16_t, Capacity>& loc,
+         const std::vector<std::vector<Exchange>>& sw = {},
          const double initCostFixed = 0, const std::size_t searchDepth = 0)
         : costFixed(initCostFixed), depth(searchDepth) {
       std::copy(q.begin(), q.end(), qubits.begin());
       std::copy(loc.begin(), loc.end(), locations.begin());
-      std::copy(sw.begin(), sw.end(), std::back_inserter(swaps));
+      recalculateHash();
+      for (const auto& swapNode : sw) {
+        for (const auto& swap : swapNode) {
+          addSwap(swap);
+        }
+      }
+    }
+    Node(const std::array<std::int16_t, Capacity>& q,
+         const std::array<std::int16_t, Capacity>& loc,
+         std::shared_ptr<const SwapChain> sw, const double initCostFixed = 0,
+         const std::size_t searchDepth = 0)
+        : costFixed(initCostFixed), previousSwaps(std::move(sw)),
+          depth(searchDepth) {
+      std::copy(q.begin(), q.end(), qubits.begin());
+      std::copy(loc.begin(), loc.end(), locations.begin());
+      recalculateHash();
+    }
+
+    /**
+     * @brief creates a child of this node in the search tree, i.e. a node
+     * with the same mapping, hash, fixed and heuristic cost to which one more
+     * swap is applied afterwards
+     *
+     * @param swapChain the swaps of this node as returned by `getSwapChain`
+     */
+    [[nodiscard]] Node
+    createChild(std::shared_ptr<const SwapChain> swapChain) const {
+      Node child{};
+      child.costFixed        = costFixed;
+      child.costHeur         = costHeur;
+      child.qubits           = qubits;
+      child.locations        = locations;
+      child.hash             = hash;
+      child.done             = done;
+      child.nonAdjacentPairs = nonAdjacentPairs;
+      child.previousSwaps    = std::move(swapChain);
+      child.nswaps           = nswaps;
+      child.depth            = depth + 1;
+      return child;
+    }
+
+    /**
+     * @brief returns the Zobrist key of logical qubit `logical` being mapped
+     * to physical qubit `physical`
+     *
+     * Keys are derived on the fly by a splitmix64 finalizer instead of being
+     * stored in a table. Unmapped physical qubits do not contribute to the
+     * hash.
+     */
+    [[nodiscard]] static constexpr std::uint64_t
+    zobristKey(const std::size_t physical, const std::int16_t logical) {
+      if (logical == DEFAULT_POSITION) {
+        return 0;
+      }
+      std::uint64_t key = (static_cast<std::uint64_t>(physical) << 16U) |
+                          static_cast<std::uint16_t>(logical);
+      key += 0x9e3779b97f4a7c15ULL;
+      key = (key ^ (key >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+      key = (key ^ (key >> 27U)) * 0x94d049bb133111ebULL;
+      return key ^ (key >> 31U);
+    }
+
+    /**
+     * @brief recalculates `hash` from scratch based on `qubits`
+     */
+    void recalculateHash() {
+      hash = 0;
+      for (std::size_t i = 0; i < qubits.size(); ++i) {
+        hash ^= zobristKey(i, qubits[i]);
+      }
     }
 
     /**
@@ -95,6 +257,15 @@ public:
       return costFixed + costHeur + lookaheadPenalty;
     }
 
+    /**
+     * @brief returns the cost by which the node is ordered in the open list of
+     * partial-expansion A*, i.e. the maximum of its total cost and the cost of
+     * its next best children not added to the open list yet
+     */
+    [[nodiscard]] double getStoredCost() const {
+      return std::max(getTotalCost(), nextChildCost);
+    }
+
     /**
      * @brief returns costFixed + lookaheadPenalty
      */
@@ -102,6 +273,58 @@ public:
       return costFixed + lookaheadPenalty;
     }
 
+    /**
+     * @brief returns the shared chain of all swaps used to get from the
+     * mapping after the last layer to the current mapping (`nullptr` if no
+     * swaps were used)
+     *
+     * Creates at most one new record, which is meant to be shared by all
+     * children of this node.
+     *
+     * @param resource memory resource from which a new record is allocated
+     */
+    [[nodiscard]] std::shared_ptr<const SwapChain>
+    getSwapChain(std::pmr::memory_resource* resource =
+                     std::pmr::get_default_resource()) const {
+      if (!lastSwap.has_value()) {
+        return previousSwaps;
+      }
+      return std::allocate_shared<SwapChain>(
+          std::pmr::polymorphic_allocator<SwapChain>(resource),
+          SwapChain{previousSwaps, *lastSwap});
+    }
+
+    /**
+     * @brief reconstructs the swaps used to get from the mapping after the
+     * last layer to the current mapping (in the order they are applied)
+     */
+    [[nodiscard]] std::vector<Exchange> getSwaps() const;
+
+    /**
+     * @brief appends a swap to the swaps of the node
+     */
+    void addSwap(const Exchange& swap) {
+      if (lastSwap.has_value()) {
+        previousSwaps = std::make_shared<const SwapChain>(
+            SwapChain{previousSwaps, *lastSwap});
+      }
+      lastSwap = swap;
+    }
+
+    /**
+     * @brief replaces the records of the swaps of the node by copies from the
+     * default memory resource, so that the node stays valid once the memory
+     * resource its swaps were allocated from is reset
+     */
+    void detachSwaps() {
+      const auto swaps = getSwaps();
+      previousSwaps    = nullptr;
+      lastSwap.reset();
+      for (const auto& swap : swaps) {
+        addSwap(swap);
+      }
+    }
+
     /**
      * @brief applies an in-place swap of 2 qubits in `qubits` and `locations`
      * of the node
@@ -136,11 +359,154 @@ public:
      * @param admissibleHeuristic controls if the heuristic should be calculated
      * such that it is admissible (i.e. A*-search should yield the optimal
      * solution using this heuristic)
+     * @param swapCountBound if true (and `admissibleHeuristic` is set), the
+     * heuristic cost is raised to `Node::swapCountLowerBound` times the cost
+     * of a swap, unless teleportations are in use
+     * @param patternDatabase pattern database of the architecture used for the
+     * swap count bound (may be `nullptr`)
+     */
+    void updateHeuristicCost(
+        const Architecture&         arch,
+        const TwoQubitMultiplicity& twoQubitGateMultiplicity,
+        bool admissibleHeuristic, bool swapCountBound = false,
+        const PatternDatabase* patternDatabase = nullptr);
+
+    /**
+     * @brief incrementally updates `Node::costHeur` and `Node::done` of a node
+     * created by `createChild` after a single swap (or teleportation) has been
+     * applied to it
+     *
+     * Only the qubit pairs containing one of the two exchanged logical qubits
+     * are reevaluated (see `Node::scoreSwaps`). In the admissible case a full
+     * recalculation is performed if the pair determining the maximum got
+     * cheaper.
+     *
+     * @param arch the architecture for calculating distances between physical
+     * qubits and supplying qubit information such as fidelity
+     * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+     * of logical qubits in the current layer
+     * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+     * qubit as created by `BasicHeuristicMapper::createMultiplicityIndex`
+     * @param parent the node this node was created from (with up to date
+     * heuristic cost)
+     * @param swap the physical qubits exchanged by the last swap
+     * @param admissibleHeuristic controls if the heuristic should be calculated
+     * such that it is admissible (i.e. A*-search should yield the optimal
+     * solution using this heuristic)
+     */
+    void updateHeuristicCostAfterSwap(
+        const Architecture&              arch,
+        const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+        const TwoQubitMultiplicityIndex& multiplicityIndex, const Node& parent,
+        const Edge& swap, bool admissibleHeuristic);
+
+    /**
+     * @brief computes the heuristic cost of the children of this node for all
+     * given swaps without creating them
+     *
+     * For each swap only the qubit pairs containing one of the two exchanged
+     * logical qubits are reevaluated. The pairs affected by all swaps are
+     * collected first and then evaluated in a single pass by
+     * `SwapScoreBatch`. In the admissible case the score of a swap is left
+     * invalid if the pair determining the maximum got cheaper.
+     *
+     * @param arch the architecture for calculating distances between physical
+     * qubits
+     * @param multiplicityIndex index of the two qubit gates acting on pairs of
+     * logical qubits in the current layer by logical qubit (see
+     * `BasicHeuristicMapper::createMultiplicityIndex`)
+     * @param swaps the physical qubits exchanged by each swap
+     * @param admissibleHeuristic controls if the heuristic should be calculated
+     * such that it is admissible (i.e. A*-search should yield the optimal
+     * solution using this heuristic)
+     * @return the score of each swap (in the order of `swaps`)
      */
-    void
-    updateHeuristicCost(const Architecture&         arch,
+    [[nodiscard]] std::vector<SwapScore>
+    scoreSwaps(const Architecture&              arch,
+               const TwoQubitMultiplicityIndex& multiplicityIndex,
+               const std::vector<Edge>& swaps, bool admissibleHeuristic) const;
+
+    /**
+     * @brief sets `Node::costHeur` and `Node::done` of a node created by
+     * `createChild` after a single swap has been applied to it from the score
+     * of the swap, or recalculates them if the score is invalid
+     *
+     * @param score score of the swap as returned by `Node::scoreSwaps` for the
+     * parent node
+     * @param arch the architecture for calculating distances between physical
+     * qubits
+     * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+     * of logical qubits in the current layer
+     * @param admissibleHeuristic controls if the heuristic should be calculated
+     * such that it is admissible
+     * @param swapCountBound see `Node::updateHeuristicCost`
+     * @param patternDatabase see `Node::updateHeuristicCost`
+     */
+    void applySwapScore(const SwapScore& score, const Architecture& arch,
+                        const TwoQubitMultiplicity& twoQubitGateMultiplicity,
+                        bool                        admissibleHeuristic,
+                        bool                        swapCountBound  = false,
+                        const PatternDatabase*      patternDatabase = nullptr);
+
+    /**
+     * @brief returns a lower bound on the number of swaps needed until all
+     * logical qubit pairs sharing gates in the current layer are mapped next to
+     * each other
+     *
+     * A pair at distance `d` needs at least `floor(d / w)` swaps, where `w` is
+     * the highest cost of a swap on any edge (the distance of a pair adds at
+     * most the cost of a direction reversal to the swaps on its path). The
+     * pairs are greedily matched to a set of pairs without common qubits.
+     * Since a swap moves only two qubits, it brings at most two of the matched
+     * pairs closer by one swap each, so that the swaps needed by the matched
+     * pairs add up to at least twice the number of swaps. The bound is the
+     * maximum of this and the swaps needed by any single pair.
+     *
+     * With a pattern database, the swaps of single pairs are exact and the
+     * matched pairs are additionally grouped two by two, so that the bound
+     * also considers the swaps needed by two pairs together (a swap reduces
+     * these by at most one for each group it moves a qubit of).
+     *
+     * The bound is only valid for distances without teleportations.
+     */
+    [[nodiscard]] std::size_t
+    swapCountLowerBound(const Architecture&         arch,
                         const TwoQubitMultiplicity& twoQubitGateMultiplicity,
-                        bool                        admissibleHeuristic);
+                        const PatternDatabase* patternDatabase = nullptr) const;
+
+    /**
+     * @brief returns the contribution of a logical qubit pair sharing gates in
+     * the current layer to `Node::costHeur`, if the qubits are mapped to the
+     * physical qubits `loc1` and `loc2`
+     *
+     * @param multiplicity number of gates acting on the pair in each direction
+     * (as stored in `TwoQubitMultiplicity`)
+     * @param admissibleHeuristic if true, the maximum distance of both
+     * directions in use is returned, otherwise the distances weighted by their
+     * multiplicity are summed up
+     */
+    static double pairHeuristicCost(
+        const Architecture& arch, std::uint16_t loc1, std::uint16_t loc2,
+        const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+        bool                                           admissibleHeuristic) {
+      const auto& [straightMultiplicity, reverseMultiplicity] = multiplicity;
+
+      const double swapCostStraight = arch.distance(loc1, loc2);
+      const double swapCostReverse  = arch.distance(loc2, loc1);
+
+      if (admissibleHeuristic) {
+        double cost = 0.;
+        if (straightMultiplicity > 0) {
+          cost = std::max(cost, swapCostStraight);
+        }
+        if (reverseMultiplicity > 0) {
+          cost = std::max(cost, swapCostReverse);
+        }
+        return cost;
+      }
+      return swapCostStraight * straightMultiplicity +
+             swapCostReverse * reverseMultiplicity;
+    }
 
     std::ostream& print(std::ostream& out) const {
       out << "{\n";
@@ -153,10 +519,325 @@ public:
       out << "\t\"nswaps\": " << nswaps << "\n}\n";
       return out;
     }
+
+    friend bool operator<(const Node& x, const Node& y) {
+      auto itx = x.qubits.begin(); // NOLINT (readability-qualified-auto)
+      auto ity = y.qubits.begin(); // NOLINT (readability-qualified-auto)
+      while (itx != x.qubits.end() && ity != y.qubits.end()) {
+        if (*itx != *ity) {
+          return *itx < *ity;
+        }
+        ++itx;
+        ++ity;
+      }
+      return false;
+    }
+
+    friend bool operator==(const Node& x, const Node& y) {
+      // only compare the full mapping on hash collisions
+      return x.hash == y.hash && x.qubits == y.qubits;
+    }
+
+    friend bool operator>(const Node& x, const Node& y) {
+      const auto xcost = x.getTotalCost();
+      const auto ycost = y.getTotalCost();
+      if (std::abs(xcost - ycost) > 1e-6) {
+        return xcost > ycost;
+      }
+
+      if (x.done) {
+        return false;
+      }
+      if (y.done) {
+        return true;
+      }
+
+      const auto xheur = x.costHeur + x.lookaheadPenalty;
+      const auto yheur = y.costHeur + y.lookaheadPenalty;
+      if (std::abs(xheur - yheur) > 1e-6) {
+        return xheur > yheur;
+      }
+      return x < y;
+    }
   };
 
+  /**
+   * @brief hash function for search nodes based on their mapping (consistent
+   * with the equality of search nodes)
+   */
+  struct NodeHash {
+    std::size_t operator()(const Node& node) const {
+      return static_cast<std::size_t>(node.hash);
+    }
+  };
+
+  /**
+   * @brief creates the index of the given multiplicity map by logical qubit
+   */
+  static TwoQubitMultiplicityIndex
+  createMultiplicityIndex(const TwoQubitMultiplicity& twoQubitGateMultiplicity);
+
+  /**
+   * @brief sets the cache of solved layers used with
+   * `Configuration::cacheLayerSolutions` (e.g. to share it with other mappers
+   * of the same architecture); if none is set, the mapper creates its own
+   */
+  void setLayerCache(std::shared_ptr<LayerCache> cache) {
+    layerCache = std::move(cache);
+  }
+  [[nodiscard]] const std::shared_ptr<LayerCache>& getLayerCache() const {
+    return layerCache;
+  }
+
 protected:
-  UniquePriorityQueue<Node> nodes{};
+  /**
+   * @brief logical qubit pairs (control, target) acted on by two-qubit gates
+   * in some lookahead layers together with a weight for each pair
+   *
+   * The lookahead penalty of a node is `factor` times the combination (as in
+   * `BasicHeuristicMapper::heuristicAddition`) of the weighted distances of all
+   * pairs.
+   */
+  struct LookaheadGroup {
+    double                               factor = 1.;
+    std::vector<std::pair<Edge, double>> pairs{};
+  };
+
+  /**
+   * @brief all lookahead layers following some circuit layer, aggregated into
+   * groups of weighted qubit pairs
+   *
+   * For the non-admissible heuristic all layers are merged into a single
+   * group where each unique pair is weighted by the sum of the lookahead
+   * factors of all gates acting on it. For the admissible heuristic the
+   * penalty of each layer is a maximum, so there is one group per layer
+   * containing its unique pairs.
+   */
+  using LookaheadWindow = std::vector<LookaheadGroup>;
+
+  using OpenList = IndexedPriorityQueue<Node, std::greater<>, NodeHash>;
+
+  /**
+   * @brief memory of the swap records and open list indices of the search of
+   * the current layer, reset at the start of each layer (see
+   * `BasicHeuristicMapper::resetSearchArena`)
+   *
+   * If `Configuration::memoryLimit` is set, the arena releases memory instead
+   * of keeping it until the next layer, so that pruned nodes are freed.
+   *
+   * Not used by HDA* (whose threads allocate concurrently) and IDA* (whose
+   * memory is meant to stay bounded).
+   */
+  SearchArena searchArena{};
+
+  OpenList nodes{&searchArena};
+
+  /**
+   * @brief mapping of a node as recorded in
+   * `BasicHeuristicMapper::closedNodes`
+   */
+  struct ClosedMapping {
+    std::uint64_t                      hash = 0;
+    std::array<std::int16_t, Capacity> qubits{};
+
+    friend bool operator==(const ClosedMapping& x, const ClosedMapping& y) {
+      // only compare the full mapping on hash collisions
+      return x.hash == y.hash && x.qubits == y.qubits;
+    }
+  };
+
+  struct ClosedMappingHash {
+    std::size_t operator()(const ClosedMapping& mapping) const {
+      return static_cast<std::size_t>(mapping.hash);
+    }
+  };
+
+  /**
+   * @brief lowest fixed cost with which each mapping has been expanded by the
+   * A*-search of the current layer
+   *
+   * If `Configuration::memoryLimit` is set, the most expensive entries are
+   * evicted whenever the set exceeds a share `MEMORY_LIMIT_CLOSED_SET_SHARE`
+   * of the limit (see `BasicHeuristicMapper::evictClosedNodes`).
+   */
+  using ClosedSet =
+      std::pmr::unordered_map<ClosedMapping, double, ClosedMappingHash>;
+  ClosedSet closedNodes{&searchArena};
+
+  /**
+   * @brief approximate number of bytes allocated by
+   * `BasicHeuristicMapper::closedNodes`
+   */
+  [[nodiscard]] std::size_t closedNodesMemoryUsage() const {
+    // entry, pointer to the next entry and cached hash
+    constexpr auto nodeSize = sizeof(typename ClosedSet::value_type) +
+                              sizeof(void*) + sizeof(std::size_t);
+    return closedNodes.size() * nodeSize +
+           closedNodes.bucket_count() * sizeof(void*);
+  }
+
+  /**
+   * @brief evicts the entries with the highest fixed cost from
+   * `BasicHeuristicMapper::closedNodes` if it uses more than a share
+   * `MEMORY_LIMIT_CLOSED_SET_SHARE` of `Configuration::memoryLimit`, keeping
+   * as many entries as fit into a fraction `MEMORY_LIMIT_PRUNE_TARGET` of the
+   * share
+   *
+   * The mappings reached most cheaply, from which the largest parts of the
+   * search would be repeated, are kept. Evicted mappings may be expanded
+   * again; a search which does not reach a goal because of this (or because
+   * of pruning the open list) is abandoned after
+   * `BasicHeuristicMapper::memoryLimitExpansionBound`.
+   *
+   * @return the number of bytes still used by the closed set
+   */
+  std::size_t evictClosedNodes();
+
+  /**
+   * @brief orders search nodes like `operator>` but by the total cost with the
+   * heuristic parts weighted by `weight`, i.e. `costFixed + weight * (costHeur
+   * + lookaheadPenalty)`
+   */
+  struct WeightedNodeCompare {
+    double weight = 1.;
+
+    bool operator()(const Node& x, const Node& y) const {
+      const auto xcost =
+          x.costFixed + weight * (x.costHeur + x.lookaheadPenalty);
+      const auto ycost =
+          y.costFixed + weight * (y.costHeur + y.lookaheadPenalty);
+      if (std::abs(xcost - ycost) > 1e-6) {
+        return xcost > ycost;
+      }
+      return x > y;
+    }
+  };
+
+  using WeightedOpenList =
+      IndexedPriorityQueue<Node, WeightedNodeCompare, NodeHash>;
+
+  /**
+   * @brief orders search nodes like `operator>` but by their stored cost
+   * (`Node::getStoredCost`) instead of their total cost, as used in
+   * partial-expansion A*
+   */
+  struct StoredCostNodeCompare {
+    bool operator()(const Node& x, const Node& y) const {
+      const auto xcost = x.getStoredCost();
+      const auto ycost = y.getStoredCost();
+      if (std::abs(xcost - ycost) > 1e-6) {
+        return xcost > ycost;
+      }
+
+      if (x.done) {
+        return false;
+      }
+      if (y.done) {
+        return true;
+      }
+
+      // prefer children over re-added nodes (with the same stored cost)
+      const auto xheur = x.costHeur + x.lookaheadPenalty;
+      const auto yheur = y.costHeur + y.lookaheadPenalty;
+      if (std::abs(xheur - yheur) > 1e-6) {
+        return xheur > yheur;
+      }
+      return x < y;
+    }
+  };
+
+  /**
+   * @brief open list of partial-expansion A*, where of two nodes with the same
+   * mapping the one with the lower total cost is kept (regardless of their
+   * stored costs)
+   */
+  using PartialExpansionOpenList =
+      IndexedPriorityQueue<Node, StoredCostNodeCompare, NodeHash,
+                           std::equal_to<Node>, 4, std::greater<>>;
+
+  /**
+   * @brief point in time at which the time budget of the current mapping run
+   * (`Configuration::timeout`) is exhausted
+   */
+  std::chrono::steady_clock::time_point mappingDeadline{};
+
+  /**
+   * @brief true if the last call of `BasicHeuristicMapper::anytimeAStarMap`
+   * was stopped by its time budget before completing its runs
+   */
+  bool anytimeSearchExpired = false;
+
+  /**
+   * @brief locations of the teleportation qubits for which the teleportation
+   * edges in `architecture` and `teleportationEdges` have been set up
+   * (`std::nullopt` if they have not been set up in the current mapping run)
+   */
+  std::optional<std::vector<std::int16_t>> teleportationLocations{};
+  /**
+   * @brief for each physical qubit the teleportation edges incident to it,
+   * which are not already part of the coupling map
+   */
+  std::vector<std::vector<Edge>> teleportationEdges{};
+
+  /**
+   * @brief lowest fixed cost with which a mapping has been reached in an IDA*
+   * iteration
+   */
+  struct TranspositionEntry {
+    std::uint64_t hash      = 0;
+    std::size_t   iteration = 0;
+    double        costFixed = 0.;
+  };
+  /**
+   * @brief transposition table of IDA* (direct-mapped by hash, colliding
+   * entries are overwritten), kept across layers to avoid reallocating it
+   */
+  std::vector<TranspositionEntry> transpositionTable{};
+  /**
+   * @brief number of IDA* iterations so far; only entries of the current
+   * iteration are valid
+   */
+  std::size_t transpositionIteration = 0;
+
+  /**
+   * @brief threads used to evaluate the children of a search node or as search
+   * threads of HDA* (`nullptr` if `Configuration::nThreads` does not exceed 1)
+   */
+  std::unique_ptr<WorkerPool> workerPool{};
+
+  /**
+   * @brief pattern database of the architecture, built (or loaded) on the
+   * first call of `map` with `Configuration::usePatternDatabase` and kept as
+   * long as the coupling map does not change
+   */
+  std::shared_ptr<const PatternDatabase> patternDatabase{};
+
+  /**
+   * @brief swaps found for the layers solved so far (only used with
+   * `Configuration::cacheLayerSolutions`)
+   */
+  std::shared_ptr<LayerCache> layerCache{};
+
+  /**
+   * @brief returns the pattern database to be used by the heuristic of the
+   * current mapping (`nullptr` if none is to be used)
+   */
+  [[nodiscard]] const PatternDatabase* activePatternDatabase() const {
+    const auto& config = results.config;
+    return config.admissibleHeuristic && config.usePatternDatabase
+               ? patternDatabase.get()
+               : nullptr;
+  }
+
+  /**
+   * @brief returns true if the heuristic of the current mapping includes the
+   * swap count bound (see `Node::swapCountLowerBound`)
+   */
+  [[nodiscard]] bool useSwapCountBound() const {
+    const auto& config = results.config;
+    return config.admissibleHeuristic &&
+           (config.swapCountBound || config.usePatternDatabase);
+  }
 
   /**
    * @brief creates an initial mapping of logical qubits to physical qubits with
@@ -212,56 +893,394 @@ protected:
   virtual void
   mapUnmappedGates(const TwoQubitMultiplicity& twoQubitGateMultiplicity);
 
+  /**
+   * @brief releases all memory of `BasicHeuristicMapper::searchArena` for
+   * reuse by the search of the next layer (after clearing
+   * `BasicHeuristicMapper::nodes` and `BasicHeuristicMapper::closedNodes`)
+   *
+   * No search node of an earlier layer whose swaps are stored in the arena may
+   * be alive at this point (see `BasicHeuristicMapper::Node::detachSwaps`).
+   */
+  void resetSearchArena() {
+    nodes.clear();
+    ClosedSet(&searchArena).swap(closedNodes);
+    searchArena.reset(results.config.memoryLimit > 0);
+  }
+
   /**
    * @brief search for an optimal mapping/set of swaps using A*-search and the
-   * heuristic specified in `HeuristicMapper::Node::updateHeuristicCost`
+   * heuristic specified in `BasicHeuristicMapper::Node::updateHeuristicCost`
    *
-   * uses `HeuristicMapper::nodes` as a priority queue for the A*-search,
+   * uses `BasicHeuristicMapper::nodes` as a priority queue for the A*-search,
    * assumed to be empty (or at least containing only nodes compliant with the
    * current layer in their fields `costHeur` and `done`)
    *
+   * Expanded mappings are recorded in `BasicHeuristicMapper::closedNodes`, so
+   * that a mapping reached again through a different order of swaps is only
+   * expanded again if it is reached with a lower fixed cost (counted as
+   * re-expansion).
+   *
+   * If the memory limit forces the searches of A*, HDA* or PEA* to drop nodes
+   * and they do not reach a goal within
+   * `BasicHeuristicMapper::memoryLimitExpansionBound`, the layer is mapped by
+   * `BasicHeuristicMapper::idaStarMap` instead.
+   *
+   * The solution is added to `BasicHeuristicMapper::layerCache` (with
+   * `Configuration::cacheLayerSolutions`) only if the search ran to
+   * completion, i.e. no nodes were dropped due to the memory limit and the
+   * anytime search was not stopped by its time budget.
+   *
+   * The swaps of the returned node are detached from
+   * `BasicHeuristicMapper::searchArena`, so that it remains valid after the
+   * next call.
+   *
    * @param layer index of the current circuit layer
    */
   virtual Node aStarMap(std::size_t layer);
 
   /**
-   * @brief expand the given node by calling `expand_node_add_one_swap` for all
-   * possible swaps, which creates new search nodes and adds them to
-   * `HeuristicMapper::nodes`
+   * @brief search for an optimal mapping/set of swaps using hash-distributed
+   * A*-search (HDA*) starting from the given root node
+   *
+   * Each thread of `BasicHeuristicMapper::workerPool` owns an open list
+   * containing the nodes whose hash is assigned to it. Expanded children are
+   * sent to their owners, and goal nodes update a shared incumbent. A thread
+   * only expands nodes cheaper than the incumbent, and the search terminates
+   * once all threads are idle and no nodes are in transit. With an admissible
+   * heuristic the result has the same cost as the one of the sequential
+   * search, but may be a different node of equal cost.
+   *
+   * @param root initial search node of the current layer
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the current layer
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
+   * @param layerResults receives the number of expanded, generated and pruned
+   * nodes
+   */
+  Node hdaStarMap(const Node&                              root,
+                  const std::unordered_set<std::uint16_t>& consideredQubits,
+                  const LookaheadWindow&                   lookaheadWindow,
+                  const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                  const TwoQubitMultiplicityIndex& multiplicityIndex,
+                  MappingResults::HeuristicBenchmarkInfo& layerResults);
+
+  /**
+   * @brief search for an optimal mapping/set of swaps using iterative-deepening
+   * A*-search (IDA*) starting from the given root node
+   *
+   * Each iteration is a depth-first search of all nodes whose total cost does
+   * not exceed a bound, which starts at the cost of the root and is raised to
+   * the lowest cost exceeding it in each iteration. Only the current path (with
+   * the children of each node on it) and a transposition table of
+   * `Configuration::memoryLimit` bytes (or `DEFAULT_TRANSPOSITION_TABLE_SIZE`
+   * entries) are kept in memory. With an admissible heuristic the result has
+   * the same cost as the one of `BasicHeuristicMapper::aStarMap`.
+   *
+   * @param root initial search node of the current layer
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the current layer
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
+   * @param layerResults receives the number of expanded and generated nodes
+   * (summed over all iterations)
+   */
+  Node idaStarMap(const Node&                              root,
+                  const std::unordered_set<std::uint16_t>& consideredQubits,
+                  const LookaheadWindow&                   lookaheadWindow,
+                  const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                  const TwoQubitMultiplicityIndex& multiplicityIndex,
+                  MappingResults::HeuristicBenchmarkInfo& layerResults);
+
+  /**
+   * @brief search for a mapping/set of swaps using anytime weighted A*-search
+   * starting from the given root node
+   *
+   * A weighted A*-search (with weight `Configuration::heuristicWeight`) is run
+   * until it reaches a goal node, which becomes the incumbent. The search is
+   * then restarted from the root with the weight decreased by
+   * `Configuration::heuristicWeightDecrease` (but not below 1), only
+   * considering nodes cheaper than the incumbent. This is repeated until the
+   * incumbent is proven optimal, the weight cannot be decreased any further or
+   * the time budget of the layer (`Configuration::layerTimeout`) or of the
+   * whole mapping (`Configuration::timeout`) is exhausted. The first goal node
+   * is always awaited, so that each layer is mapped.
+   *
+   * The lowest unweighted total cost of all open nodes at the end of each run
+   * is a lower bound of the optimal cost (for an admissible heuristic). The
+   * ratio of the cost of the incumbent and the best lower bound is recorded in
+   * `MappingResults::suboptimalityBound` (maximum over all layers), unless
+   * the heuristic is not admissible or lookahead is used, in which case no
+   * such bound is known.
+   * `Configuration::memoryLimit` is not considered, since dropping nodes
+   * would invalidate this bound.
+   *
+   * @param root initial search node of the current layer
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the current layer
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
+   * @param layerResults receives the number of expanded, generated and pruned
+   * nodes (summed over all runs)
+   */
+  Node
+  anytimeAStarMap(const Node&                              root,
+                  const std::unordered_set<std::uint16_t>& consideredQubits,
+                  const LookaheadWindow&                   lookaheadWindow,
+                  const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                  const TwoQubitMultiplicityIndex& multiplicityIndex,
+                  MappingResults::HeuristicBenchmarkInfo& layerResults);
+
+  /**
+   * @brief search for an optimal mapping/set of swaps using partial-expansion
+   * A*-search (PEA*) starting from the given root node
+   *
+   * Expanding a node creates all its children, but only those whose total
+   * cost does not exceed the stored cost of the node (see
+   * `Node::getStoredCost`) are added to the open list. The node itself is
+   * re-added with the lowest cost of the remaining children as its stored
+   * cost, so that these are only added once the search actually reaches their
+   * cost. This keeps most children, which are never expanded, out of the open
+   * list. With an admissible heuristic the result has the same cost as the one
+   * of the sequential search.
+   *
+   * @param root initial search node of the current layer
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the current layer
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
+   * @param layerResults receives the number of expansions (including
+   * re-expansions), generated and pruned nodes
+   */
+  Node peaStarMap(const Node&                              root,
+                  const std::unordered_set<std::uint16_t>& consideredQubits,
+                  const LookaheadWindow&                   lookaheadWindow,
+                  const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                  const TwoQubitMultiplicityIndex& multiplicityIndex,
+                  MappingResults::HeuristicBenchmarkInfo& layerResults);
+
+  /**
+   * @brief drops the worst nodes from the given open list if it uses more than
+   * `memoryLimit` bytes (together with `reservedMemory`), keeping as many nodes
+   * as fit into a fraction `MEMORY_LIMIT_PRUNE_TARGET` of the limit
+   *
+   * Dropping nodes keeps the search from exhausting the available memory, but
+   * the result may no longer be optimal, and the search may no longer
+   * terminate (see `BasicHeuristicMapper::memoryLimitExpansionBound`).
+   *
+   * @param open open list of a search
+   * @param memoryLimit maximum number of bytes (0 = unlimited)
+   * @param reservedMemory number of bytes of the limit used by other data of
+   * the search (e.g. a closed set)
+   * @return the number of dropped nodes
+   */
+  template <class Open>
+  static std::size_t pruneOpenList(Open& open, std::size_t memoryLimit,
+                                   std::size_t reservedMemory = 0);
+
+  /**
+   * @brief returns the number of expansions after which a search is abandoned,
+   * whose open list has been pruned for the first time after `expandedNodes`
+   * expansions down to `openNodes` nodes
+   *
+   * Pruning may drop all nodes through which a goal can be reached, so that
+   * the search would keep expanding the remaining mappings in circles. The
+   * layer is then mapped by `BasicHeuristicMapper::idaStarMap`, which only
+   * needs memory for its current path and always terminates.
+   */
+  static std::size_t memoryLimitExpansionBound(const std::size_t expandedNodes,
+                                               const std::size_t openNodes) {
+    return expandedNodes +
+           MEMORY_LIMIT_FALLBACK_FACTOR * std::max<std::size_t>(1, openNodes);
+  }
+
+  /**
+   * @brief sets up the teleportation edges available from the mapping in the
+   * given node in `architecture` and `teleportationEdges`, unless they have
+   * already been set up for the same locations of the teleportation qubits
+   *
+   * @param node current search node
+   */
+  void updateTeleportationEdges(const Node& node);
+
+  /**
+   * @brief returns the swaps considered when expanding the given node, i.e. all
+   * edges incident to the physical qubits of the considered qubits (coupling
+   * edges as well as teleportation edges), each edge exactly once
    *
    * @param consideredQubits set of all qubits that are acted on by a
    * 2-qubit-gate in the respective layer
    * @param node current search node
-   * @param layer index of current circuit layer
+   */
+  [[nodiscard]] std::vector<Edge>
+  getCandidateSwaps(const std::unordered_set<std::uint16_t>& consideredQubits,
+                    const Node&                              node) const;
+
+  /**
+   * @brief returns the scores of the children of the given node for the given
+   * swaps (see `BasicHeuristicMapper::Node::scoreSwaps`), which are all invalid
+   * if teleportation qubits are used
+   *
+   * @param node current search node
+   * @param swaps candidate swaps as returned by
+   * `BasicHeuristicMapper::getCandidateSwaps`
+   * @param multiplicityIndex index of the two qubit gates acting on pairs of
+   * logical qubits in the current layer by logical qubit
+   */
+  [[nodiscard]] std::vector<SwapScore>
+  scoreCandidateSwaps(const Node& node, const std::vector<Edge>& swaps,
+                      const TwoQubitMultiplicityIndex& multiplicityIndex) const;
+
+  /**
+   * @brief expand the given node by creating its children with
+   * `BasicHeuristicMapper::createChildNodes` and adding them to
+   * `BasicHeuristicMapper::nodes` in the order of their swaps (except for
+   * children whose mapping has already been expanded with at most the same
+   * fixed cost, see `BasicHeuristicMapper::closedNodes`)
+   *
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the respective layer
+   * @param node current search node
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
    * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
    * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
    */
   void expandNode(const std::unordered_set<std::uint16_t>& consideredQubits,
-                  Node& node, std::size_t layer,
-                  const TwoQubitMultiplicity& twoQubitGateMultiplicity);
+                  Node& node, const LookaheadWindow& lookaheadWindow,
+                  const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                  const TwoQubitMultiplicityIndex& multiplicityIndex);
+
+  /**
+   * @brief creates and evaluates the children of the given node for all
+   * possible swaps (see `BasicHeuristicMapper::getCandidateSwaps`), in
+   * parallel if `BasicHeuristicMapper::workerPool` is set up
+   *
+   * The heuristic costs of all children are computed in a single pass by
+   * `BasicHeuristicMapper::scoreCandidateSwaps` before the children are
+   * created.
+   *
+   * @param consideredQubits set of all qubits that are acted on by a
+   * 2-qubit-gate in the respective layer
+   * @param node current search node
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the current layer
+   * @param multiplicityIndex index of `twoQubitGateMultiplicity` by logical
+   * qubit
+   * @param resource memory resource from which the swap record shared by the
+   * children is allocated
+   * @return the children in the order of their swaps
+   */
+  std::vector<Node>
+  createChildNodes(const std::unordered_set<std::uint16_t>& consideredQubits,
+                   const Node& node, const LookaheadWindow& lookaheadWindow,
+                   const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+                   const TwoQubitMultiplicityIndex& multiplicityIndex,
+                   std::pmr::memory_resource*       resource =
+                       std::pmr::get_default_resource());
 
   /**
-   * @brief creates a new node with a swap on the given edge and adds it to
-   * `HeuristicMapper::nodes`
+   * @brief creates a new node with a swap on the given edge and evaluates its
+   * costs
+   *
+   * Only reads from the mapper and the architecture, so that it can be called
+   * for several swaps concurrently.
    *
    * @param swap edge on which to perform a swap
+   * @param score score of the swap as returned by
+   * `BasicHeuristicMapper::scoreCandidateSwaps`
    * @param node current search node
-   * @param layer index of current circuit layer
+   * @param swapChain the swaps of the current search node as obtained by
+   * `BasicHeuristicMapper::Node::getSwapChain` (shared by all its children)
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer
    * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
    * of logical qubits in the current layer
    */
-  void
-  expandNodeAddOneSwap(const Edge& swap, Node& node, std::size_t layer,
+  Node createChildNode(const Edge& swap, const SwapScore& score,
+                       const Node&                             node,
+                       const std::shared_ptr<const SwapChain>& swapChain,
+                       const LookaheadWindow&                  lookaheadWindow,
                        const TwoQubitMultiplicity& twoQubitGateMultiplicity);
 
+  /**
+   * @brief collects the two-qubit gates of the `Configuration::nrLookaheads`
+   * layers following the given layer, weighted by their lookahead factors
+   *
+   * @param layer index of current circuit layer
+   */
+  LookaheadWindow createLookaheadWindow(std::size_t layer);
+
+  /**
+   * @brief describes the subproblem of mapping the given layer from the
+   * current mapping for `BasicHeuristicMapper::layerCache`
+   *
+   * The key consists of the physical qubits of each qubit pair of the layer
+   * with its multiplicity, and of the physical qubits of the gates in each
+   * lookahead layer. Since swaps and their costs do not depend on any other
+   * qubits, the same swaps solve all subproblems with the same key.
+   *
+   * @param layer index of current circuit layer
+   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
+   * of logical qubits in the layer
+   * @return the key, or `std::nullopt` if the subproblem is not to be cached
+   * (since the lookahead penalty of unmapped qubits depends on all free
+   * physical qubits)
+   */
+  std::optional<LayerCache::Key>
+  createLayerCacheKey(std::size_t                 layer,
+                      const TwoQubitMultiplicity& twoQubitGateMultiplicity);
+
+  /**
+   * @brief describes the settings of the given configuration which affect the
+   * swaps found for a layer, so that `BasicHeuristicMapper::layerCache` is not
+   * invalidated by other settings (e.g. the number of threads)
+   *
+   * Time and memory limits are not part of the description, since solutions
+   * of searches cut short by them are not cached (see
+   * `BasicHeuristicMapper::aStarMap`).
+   */
+  static std::string layerCacheConfiguration(const Configuration& config);
+
+  /**
+   * @brief applies the given swaps (as stored in
+   * `BasicHeuristicMapper::layerCache`) to the given node
+   *
+   * @return the resulting node with costs as if it had been found by a search
+   */
+  Node replaySwaps(const Node& root, const std::vector<Edge>& swaps,
+                   const LookaheadWindow&      lookaheadWindow,
+                   const TwoQubitMultiplicity& twoQubitGateMultiplicity);
+
   /**
    * @brief calculates the heuristic cost for the following layers and saves it
    * in the node as `lookaheadPenalty`
    *
-   * @param layer index of current circuit layer
+   * @param lookaheadWindow the lookahead layers following the current circuit
+   * layer as created by `BasicHeuristicMapper::createLookaheadWindow`
    * @param node search node for which to calculate lookahead penalty
    */
-  void lookahead(std::size_t layer, Node& node);
+  void lookahead(const LookaheadWindow& lookaheadWindow, Node& node);
 
   double heuristicAddition(const double currentCost, const double newCost) {
     if (results.config.admissibleHeuristic) {
@@ -297,39 +1316,87 @@ protected:
   }
 };
 
-inline bool operator<(const HeuristicMapper::Node& x,
-                      const HeuristicMapper::Node& y) {
-  auto itx = x.qubits.begin(); // NOLINT (readability-qualified-auto)
-  auto ity = y.qubits.begin(); // NOLINT (readability-qualified-auto)
-  while (itx != x.qubits.end() && ity != y.qubits.end()) {
-    if (*itx != *ity) {
-      return *itx < *ity;
-    }
-    ++itx;
-    ++ity;
+/**
+ * Heuristic mapper for architectures of up to `MAX_DEVICE_QUBITS` qubits.
+ *
+ * Each mapping run is carried out by the instantiation of
+ * `BasicHeuristicMapper` with the smallest capacity in `NODE_CAPACITIES`
+ * fitting the architecture, which is kept for subsequent runs.
+ */
+class HeuristicMapper : public Mapper {
+public:
+  using Mapper::Mapper; // import constructors from parent class
+
+  /** capacities for which `BasicHeuristicMapper` is instantiated */
+  static constexpr std::array<std::uint16_t, 6> NODE_CAPACITIES = {
+      16, 32, 64, 128, 256, MAX_DEVICE_QUBITS};
+
+  using Node     = BasicHeuristicMapper<MAX_DEVICE_QUBITS>::Node;
+  using NodeHash = BasicHeuristicMapper<MAX_DEVICE_QUBITS>::NodeHash;
+
+  static constexpr double EFFECTIVE_BRANCH_RATE_TOLERANCE =
+      BasicHeuristicMapper<MAX_DEVICE_QUBITS>::EFFECTIVE_BRANCH_RATE_TOLERANCE;
+
+  /**
+   * @brief map the circuit passed at initialization to the architecture
+   *
+   * @param config the settings for this mapping run (controls e.g. layering
+   * methods, pre- and post-optimizations, etc.)
+   */
+  void map(const Configuration& configuration) override;
+
+  /**
+   * @brief creates the index of the given multiplicity map by logical qubit
+   */
+  static TwoQubitMultiplicityIndex createMultiplicityIndex(
+      const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
+    return BasicHeuristicMapper<MAX_DEVICE_QUBITS>::createMultiplicityIndex(
+        twoQubitGateMultiplicity);
   }
-  return false;
-}
-
-inline bool operator>(const HeuristicMapper::Node& x,
-                      const HeuristicMapper::Node& y) {
-  const auto xcost = x.getTotalCost();
-  const auto ycost = y.getTotalCost();
-  if (std::abs(xcost - ycost) > 1e-6) {
-    return xcost > ycost;
+
+  /**
+   * @brief returns the smallest capacity in `NODE_CAPACITIES` of at least the
+   * given number of qubits (0 if there is none)
+   */
+  [[nodiscard]] static constexpr std::uint16_t
+  nodeCapacity(const std::size_t nqubits) {
+    for (const auto capacity : NODE_CAPACITIES) {
+      if (nqubits <= capacity) {
+        return capacity;
+      }
+    }
+    return 0;
   }
 
-  if (x.done) {
-    return false;
+  /**
+   * @brief see `BasicHeuristicMapper::setLayerCache`
+   */
+  void setLayerCache(std::shared_ptr<LayerCache> cache) {
+    layerCache = std::move(cache);
   }
-  if (y.done) {
-    return true;
+  [[nodiscard]] const std::shared_ptr<LayerCache>& getLayerCache() const {
+    return layerCache;
   }
 
-  const auto xheur = x.costHeur + x.lookaheadPenalty;
-  const auto yheur = y.costHeur + y.lookaheadPenalty;
-  if (std::abs(xheur - yheur) > 1e-6) {
-    return xheur > yheur;
-  }
-  return x < y;
-}
+protected:
+  /** the mapper carrying out the mapping runs */
+  std::unique_ptr<Mapper> capacityMapper{};
+  /** capacity of `capacityMapper` */
+  std::uint16_t mapperCapacity = 0;
+  /** cache of solved layers handed to `capacityMapper` */
+  std::shared_ptr<LayerCache> layerCache{};
+
+  /**
+   * @brief maps the circuit with the instantiation of `BasicHeuristicMapper`
+   * of the given capacity and takes over its results
+   */
+  template <std::uint16_t Capacity>
+  void mapWithCapacity(const Configuration& configuration);
+};
+
+extern template class BasicHeuristicMapper<16>;
+extern template class BasicHeuristicMapper<32>;
+extern template class BasicHeuristicMapper<64>;
+extern template class BasicHeuristicMapper<128>;
+extern template class BasicHeuristicMapper<256>;
+extern template class BasicHeuristicMapper<MAX_DEVICE_QUBITS>;
@@ -0,0 +1,284 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/**
+ * Priority queue with unique (according to Hash and KeyEqual) elements of type
+ * T where the sorting is based on CostCompare. Of two equivalent elements the
+ * one which is lower according to ReplaceCompare is kept (by default the one
+ * sorted first).
+ *
+ * The queue is implemented as a d-ary heap (with d = Arity) of slot indices,
+ * where each slot holds one element. A hash map from the hash of an element to
+ * its slot allows to find equivalent elements in (expected) constant time, so
+ * that push, pop and decrease-key all take O(log n) time. Elements themselves
+ * are never moved while sifting through the heap.
+ */
+template <class T, class CostCompare = std::greater<T>,
+          class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>,
+          std::size_t Arity = 4, class ReplaceCompare = CostCompare>
+class IndexedPriorityQueue {
+  static_assert(Arity >= 2, "heap arity must be at least 2");
+
+public:
+  using size_type = std::size_t;
+
+  IndexedPriorityQueue() = default;
+  explicit IndexedPriorityQueue(CostCompare compare)
+      : costCompare(std::move(compare)) {}
+  /**
+   * @param resource memory resource from which the hash index of the queue
+   * (holding one entry per element) is allocated
+   */
+  explicit IndexedPriorityQueue(std::pmr::memory_resource* resource)
+      : slotsByHash(resource) {}
+  IndexedPriorityQueue(CostCompare compare, std::pmr::memory_resource* resource)
+      : costCompare(std::move(compare)), slotsByHash(resource) {}
+
+  /**
+   * Return true if the element was inserted into the queue.
+   * This happens if no equivalent element is present or if the new element has
+   * a lower cost associated to it according to ReplaceCompare (in which case
+   * the equivalent element is replaced and moved in the heap). False is
+   * returned if no insertion into the queue took place.
+   */
+  bool push(const T& v) {
+    const auto hash          = Hash()(v);
+    const auto [first, last] = slotsByHash.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+      const auto slot = it->second;
+      if (KeyEqual()(elements[slot], v)) {
+        if (!replaces(elements[slot], v)) {
+          return false;
+        }
+        const bool decrease = costCompare(elements[slot], v);
+        elements[slot]      = v;
+        if (decrease) {
+          siftUp(positions[slot]);
+        } else {
+          siftDown(positions[slot]);
+        }
+        return true;
+      }
+    }
+
+    size_type slot = 0;
+    if (freeSlots.empty()) {
+      slot = elements.size();
+      elements.emplace_back(v);
+      hashes.emplace_back(hash);
+      positions.emplace_back(heap.size());
+    } else {
+      slot = freeSlots.back();
+      freeSlots.pop_back();
+      elements[slot]  = v;
+      hashes[slot]    = hash;
+      positions[slot] = heap.size();
+    }
+    slotsByHash.emplace(hash, slot);
+    heap.emplace_back(slot);
+    siftUp(heap.size() - 1);
+    return true;
+  }
+
+  void pop() {
+    assert(!heap.empty());
+
+    const auto slot = heap.front();
+    eraseFromIndex(slot);
+    elements[slot] = T{};
+    freeSlots.emplace_back(slot);
+
+    heap.front()            = heap.back();
+    positions[heap.front()] = 0;
+    heap.pop_back();
+    if (!heap.empty()) {
+      siftDown(0);
+    }
+  }
+
+  const T& top() const {
+    assert(!heap.empty());
+    return elements[heap.front()];
+  }
+
+  [[nodiscard]] bool empty() const { return heap.empty(); }
+
+  [[nodiscard]] size_type size() const { return heap.size(); }
+
+  /**
+   * Call `function` for each element in the queue (in unspecified order).
+   */
+  template <class Function> void forEach(Function&& function) const {
+    for (const auto slot : heap) {
+      function(elements[slot]);
+    }
+  }
+
+  /**
+   * Remove all but the `n` best elements from the queue in O(size log size)
+   * time. The memory of the removed elements is released.
+   */
+  void truncate(const size_type n) {
+    if (n >= heap.size()) {
+      return;
+    }
+
+    std::vector<size_type> kept(heap);
+    std::nth_element(kept.begin(),
+                     kept.begin() + static_cast<std::ptrdiff_t>(n), kept.end(),
+                     [this](const size_type a, const size_type b) {
+                       return costCompare(elements[b], elements[a]);
+                     });
+    kept.resize(n);
+
+    std::vector<T>           keptElements{};
+    std::vector<std::size_t> keptHashes{};
+    keptElements.reserve(n);
+    keptHashes.reserve(n);
+    for (const auto slot : kept) {
+      keptElements.emplace_back(std::move(elements[slot]));
+      keptHashes.emplace_back(hashes[slot]);
+    }
+
+    HashIndex keptSlotsByHash(slotsByHash.get_allocator());
+    keptSlotsByHash.reserve(n);
+    std::vector<size_type> keptHeap(n);
+    for (size_type slot = 0; slot < n; ++slot) {
+      keptSlotsByHash.emplace(keptHashes[slot], slot);
+      keptHeap[slot] = slot;
+    }
+
+    elements.swap(keptElements);
+    hashes.swap(keptHashes);
+    slotsByHash.swap(keptSlotsByHash);
+    heap.swap(keptHeap);
+    positions = heap;
+    std::vector<size_type>().swap(freeSlots);
+
+    // restore the heap property bottom-up
+    for (auto pos = heap.size(); pos-- > 0;) {
+      siftDown(pos);
+    }
+  }
+
+  /**
+   * Approximate number of bytes allocated by the queue (not including memory
+   * owned by the elements themselves).
+   */
+  [[nodiscard]] std::size_t memoryUsage() const {
+    using HashNode = std::pair<typename decltype(slotsByHash)::value_type,
+                               void*>; // entry and pointer to next entry
+    return elements.capacity() * sizeof(T) +
+           hashes.capacity() * sizeof(std::size_t) +
+           (heap.capacity() + positions.capacity() + freeSlots.capacity()) *
+               sizeof(size_type) +
+           slotsByHash.size() * sizeof(HashNode) +
+           slotsByHash.bucket_count() * sizeof(void*);
+  }
+
+  /**
+   * Remove all elements from the queue in O(n) time.
+   *
+   * Afterwards the hash index holds no memory of its memory resource, so that
+   * the resource may be reset.
+   */
+  void clear() {
+    heap.clear();
+    elements.clear();
+    hashes.clear();
+    positions.clear();
+    freeSlots.clear();
+    HashIndex(slotsByHash.get_allocator()).swap(slotsByHash);
+  }
+
+private:
+  CostCompare costCompare{};
+  /** slot indices arranged as a d-ary heap */
+  std::vector<size_type> heap{};
+  /** elements stored by slot index */
+  std::vector<T> elements{};
+  /** hash of the element stored in each slot */
+  std::vector<std::size_t> hashes{};
+  /** position of each slot in `heap` */
+  std::vector<size_type> positions{};
+  /** slots not holding any element at the moment */
+  std::vector<size_type> freeSlots{};
+  using HashIndex = std::pmr::unordered_multimap<std::size_t, size_type>;
+  /** slots of all elements in the queue indexed by their hash */
+  HashIndex slotsByHash{};
+
+  [[nodiscard]] bool replaces(const T& existing, const T& v) const {
+    if constexpr (std::is_same_v<ReplaceCompare, CostCompare>) {
+      return costCompare(existing, v);
+    } else {
+      return ReplaceCompare()(existing, v);
+    }
+  }
+
+  [[nodiscard]] bool worse(const size_type posA, const size_type posB) const {
+    return costCompare(elements[heap[posA]], elements[heap[posB]]);
+  }
+
+  void swapPositions(const size_type posA, const size_type posB) {
+    std::swap(heap[posA], heap[posB]);
+    positions[heap[posA]] = posA;
+    positions[heap[posB]] = posB;
+  }
+
+  void siftUp(size_type pos) {
+    while (pos > 0) {
+      const auto parent = (pos - 1) / Arity;
+      if (!worse(parent, pos)) {
+        break;
+      }
+      swapPositions(parent, pos);
+      pos = parent;
+    }
+  }
+
+  void siftDown(size_type pos) {
+    while (true) {
+      const auto firstChild = pos * Arity + 1;
+      if (firstChild >= heap.size()) {
+        break;
+      }
+      const auto lastChild = std::min(firstChild + Arity, heap.size());
+      auto       best      = firstChild;
+      for (auto child = firstChild + 1; child < lastChild; ++child) {
+        if (worse(best, child)) {
+          best = child;
+        }
+      }
+      if (!worse(pos, best)) {
+        break;
+      }
+      swapPositions(pos, best);
+      pos = best;
+    }
+  }
+
+  void eraseFromIndex(const size_type slot) {
+    const auto [first, last] = slotsByHash.equal_range(hashes[slot]);
+    for (auto it = first; it != last; ++it) {
+      if (it->second == slot) {
+        slotsByHash.erase(it);
+        return;
+      }
+    }
+    assert(false);
+  }
+};
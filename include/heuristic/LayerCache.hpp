@@ -0,0 +1,116 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/**
+ * Swaps found by the heuristic mapper for the layers mapped so far, indexed by
+ * the subproblem each of them solves, so that the search can be skipped if the
+ * same subproblem comes up again (e.g. in circuits repeating the same layers).
+ *
+ * A subproblem is described by a key of physical qubits only (see
+ * `BasicHeuristicMapper::createLayerCacheKey`), so that entries apply
+ * regardless of which logical qubits are involved. Entries are only valid for
+ * one architecture and configuration; `LayerCache::validate` drops all entries
+ * once either of them changes. A cache may be shared by several mappers (also
+ * on different threads).
+ */
+class LayerCache {
+public:
+  using Key = std::vector<std::int32_t>;
+
+  /** default maximum number of entries */
+  static constexpr std::size_t DEFAULT_CAPACITY = 1U << 16U;
+
+  /**
+   * @param capacity maximum number of entries; once reached, no further
+   * entries are added
+   */
+  explicit LayerCache(const std::size_t capacity = DEFAULT_CAPACITY)
+      : capacity(capacity) {}
+
+  /**
+   * @brief removes all entries if they were created for a different
+   * architecture or configuration than the given ones
+   *
+   * @param architectureHash identifies the coupling map of the architecture
+   * @param configuration identifies the settings of the mapper
+   */
+  void validate(const std::uint64_t architectureHash,
+                const std::string&  configuration) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (architectureHash != validArchitecture ||
+        configuration != validConfiguration) {
+      entries.clear();
+      validArchitecture  = architectureHash;
+      validConfiguration = configuration;
+    }
+  }
+
+  /**
+   * @brief returns the swaps stored for the given subproblem (if any)
+   */
+  [[nodiscard]] std::optional<std::vector<Edge>> find(const Key& key) const {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const auto                        it = entries.find(key);
+    if (it == entries.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief stores the swaps solving the given subproblem (unless the cache is
+   * full)
+   */
+  void insert(Key key, std::vector<Edge> swaps) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (entries.size() < capacity) {
+      entries.try_emplace(std::move(key), std::move(swaps));
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  void clear() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+  }
+
+private:
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      std::size_t result = key.size();
+      for (const auto value : key) {
+        result ^= static_cast<std::size_t>(value) + 0x9e3779b9U +
+                  (result << 6U) + (result >> 2U);
+      }
+      return result;
+    }
+  };
+
+  std::size_t        capacity;
+  mutable std::mutex mutex{};
+
+  std::unordered_map<Key, std::vector<Edge>, KeyHash> entries{};
+
+  /** architecture and configuration the entries were created for */
+  std::uint64_t validArchitecture = 0;
+  std::string   validConfiguration{};
+};
@@ -0,0 +1,141 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "Architecture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma once
+
+/**
+ * Exact minimum numbers of swaps needed to bring small groups of logical
+ * qubits next to each other on an architecture, i.e. the swaps needed if all
+ * other qubits could be ignored.
+ *
+ * Two tables are precomputed by breadth-first search over the placements of
+ * the qubits of a group (swaps only exchange qubits along the edges of the
+ * coupling map, so the direction of the edges is irrelevant):
+ *  - for single pairs (for architectures of up to `MAX_DEVICE_QUBITS` qubits)
+ *  - for two disjoint pairs which are to be made adjacent simultaneously (for
+ *    architectures of up to `MAX_TWO_PAIR_QUBITS` qubits, since the table
+ *    holds one entry per placement of 4 qubits)
+ *
+ * As building the tables for larger architectures takes some time, databases
+ * can be stored on disk and are identified by a hash of the coupling map (see
+ * `PatternDatabase::loadOrCreate`). Files are written in native byte order.
+ */
+class PatternDatabase {
+public:
+  using Entry = std::uint8_t;
+
+  /** largest architecture for which the table of two pairs is built */
+  static constexpr std::uint16_t MAX_TWO_PAIR_QUBITS = 32;
+
+  PatternDatabase() = default;
+  /**
+   * @brief builds the database for the coupling map of the given architecture
+   */
+  explicit PatternDatabase(const Architecture& arch);
+
+  /**
+   * @brief returns a hash of the number of qubits and the coupling map of the
+   * architecture, which identifies the databases built for it
+   */
+  [[nodiscard]] static std::uint64_t
+  couplingMapHash(const Architecture& arch);
+
+  [[nodiscard]] std::uint64_t getCouplingMapHash() const { return hash; }
+  [[nodiscard]] std::uint16_t getNqubits() const { return nqubits; }
+
+  /**
+   * @brief returns true if the database was built for the coupling map of the
+   * given architecture
+   */
+  [[nodiscard]] bool matches(const Architecture& arch) const {
+    return nqubits == arch.getNqubits() && hash == couplingMapHash(arch);
+  }
+
+  [[nodiscard]] bool hasTwoPairTable() const { return !twoPairTable.empty(); }
+
+  /**
+   * @brief minimum number of swaps until the qubits at the physical qubits
+   * `loc1` and `loc2` are adjacent (0 if they can never be adjacent)
+   */
+  [[nodiscard]] std::size_t pairSwaps(const std::uint16_t loc1,
+                                      const std::uint16_t loc2) const {
+    return value(pairTable[static_cast<std::size_t>(loc1) * nqubits + loc2]);
+  }
+
+  /**
+   * @brief minimum number of swaps until both the qubits at `loc1` and `loc2`
+   * and the qubits at `loc3` and `loc4` are adjacent (0 if this is not
+   * possible); requires `hasTwoPairTable()`
+   */
+  [[nodiscard]] std::size_t
+  twoPairSwaps(const std::uint16_t loc1, const std::uint16_t loc2,
+               const std::uint16_t loc3, const std::uint16_t loc4) const {
+    return value(twoPairTable[twoPairIndex(loc1, loc2, loc3, loc4)]);
+  }
+
+  /**
+   * @brief writes the database to the given file
+   */
+  void save(const std::string& filename) const;
+
+  /**
+   * @brief reads a database written by `PatternDatabase::save`
+   */
+  [[nodiscard]] static PatternDatabase load(const std::string& filename);
+
+  /**
+   * @brief returns the name of the file in which the database of the given
+   * architecture is stored by `PatternDatabase::loadOrCreate`
+   */
+  [[nodiscard]] static std::string filename(const Architecture& arch);
+
+  /**
+   * @brief loads the database of the given architecture from the given
+   * directory, or builds it and stores it there if it does not exist yet
+   *
+   * @param directory directory in which databases are kept; if empty, the
+   * database is only built in memory
+   */
+  [[nodiscard]] static std::shared_ptr<const PatternDatabase>
+  loadOrCreate(const Architecture& arch, const std::string& directory);
+
+private:
+  /** entry of placements from which the group can never be made adjacent */
+  static constexpr Entry UNREACHABLE = std::numeric_limits<Entry>::max();
+
+  std::uint16_t nqubits = 0;
+  std::uint64_t hash    = 0;
+  /** entries indexed by `loc1 * nqubits + loc2` */
+  std::vector<Entry> pairTable{};
+  /** entries indexed by `twoPairIndex` */
+  std::vector<Entry> twoPairTable{};
+
+  [[nodiscard]] static std::size_t value(const Entry entry) {
+    return entry == UNREACHABLE ? 0U : entry;
+  }
+
+  [[nodiscard]] std::size_t twoPairIndex(const std::uint16_t loc1,
+                                         const std::uint16_t loc2,
+                                         const std::uint16_t loc3,
+                                         const std::uint16_t loc4) const {
+    return ((static_cast<std::size_t>(loc1) * nqubits + loc2) * nqubits +
+            loc3) *
+               nqubits +
+           loc4;
+  }
+
+  void buildPairTable(const std::vector<std::vector<std::uint16_t>>& neighbors);
+  void
+  buildTwoPairTable(const std::vector<std::vector<std::uint16_t>>& neighbors);
+};
@@ -0,0 +1,144 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#pragma once
+
+/**
+ * Monotonic memory resource for short-lived allocations of a search, which are
+ * all released at once by `reset`.
+ *
+ * Memory is handed out from a list of blocks by bumping a pointer, and
+ * deallocation is a no-op. Resetting rewinds to the first block in constant
+ * time, but keeps all blocks, so that subsequent searches reuse the memory
+ * without any further allocations. Not thread-safe.
+ *
+ * As nothing is freed before the next reset, searches which drop memory to
+ * stay below some limit can switch the arena to releasing memory instead (see
+ * `SearchArena::reset`).
+ */
+class SearchArena : public std::pmr::memory_resource {
+public:
+  static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1U << 16U;
+
+  SearchArena() = default;
+
+  /**
+   * @brief makes all memory handed out so far available again
+   *
+   * All objects allocated from the arena must have been destroyed before.
+   *
+   * @param releasing if true, allocations until the next reset are forwarded
+   * to `std::pmr::new_delete_resource` and freed on deallocation (instead of
+   * being taken from the blocks of the arena)
+   */
+  void reset(const bool releasing = false) {
+    assert(releasedBytesInUse == 0);
+    currentBlock    = 0;
+    offset          = 0;
+    releaseMemory   = releasing;
+    blockBytesInUse = 0;
+    peakBytesInUse  = 0;
+  }
+
+  /**
+   * @brief returns the maximum number of bytes handed out at the same time
+   * (and not deallocated again while releasing memory) since the last reset
+   */
+  [[nodiscard]] std::size_t peakUsage() const { return peakBytesInUse; }
+
+  /**
+   * @brief returns the total number of bytes held by the arena
+   */
+  [[nodiscard]] std::size_t capacity() const {
+    std::size_t total = 0;
+    for (const auto& block : blocks) {
+      total += block.size;
+    }
+    return total;
+  }
+
+private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data; // NOLINT(*-avoid-c-arrays)
+    std::size_t                  size = 0;
+  };
+
+  std::vector<Block> blocks{};
+  /** index of the block allocations are currently taken from */
+  std::size_t currentBlock = 0;
+  /** number of bytes used in the current block */
+  std::size_t offset = 0;
+  /** whether memory is currently forwarded to the upstream resource */
+  bool releaseMemory = false;
+  /** number of bytes currently taken from the upstream resource */
+  std::size_t releasedBytesInUse = 0;
+  /** number of bytes taken from the blocks since the last reset */
+  std::size_t blockBytesInUse = 0;
+  /** see `SearchArena::peakUsage` */
+  std::size_t peakBytesInUse = 0;
+
+  /**
+   * @brief takes the given number of bytes from the current block (`nullptr`
+   * if they do not fit)
+   */
+  void* allocateFromCurrentBlock(const std::size_t bytes,
+                                 const std::size_t alignment) {
+    auto&       block = blocks[currentBlock];
+    void*       ptr   = block.data.get() + offset;
+    std::size_t space = block.size - offset;
+    if (std::align(alignment, bytes, ptr, space) == nullptr) {
+      return nullptr;
+    }
+    offset = block.size - space + bytes;
+    return ptr;
+  }
+
+  void* do_allocate(const std::size_t bytes,
+                    const std::size_t alignment) override {
+    if (releaseMemory) {
+      releasedBytesInUse += bytes;
+      peakBytesInUse = std::max(peakBytesInUse, releasedBytesInUse);
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    blockBytesInUse += bytes;
+    peakBytesInUse = std::max(peakBytesInUse, blockBytesInUse);
+
+    for (; currentBlock < blocks.size(); ++currentBlock, offset = 0) {
+      if (auto* ptr = allocateFromCurrentBlock(bytes, alignment)) {
+        return ptr;
+      }
+    }
+
+    // blocks grow geometrically, so that their number stays small
+    const auto size =
+        std::max({DEFAULT_BLOCK_SIZE,
+                  blocks.empty() ? std::size_t{0} : 2 * blocks.back().size,
+                  bytes + alignment});
+    blocks.push_back({std::make_unique<std::byte[]>(size), size});
+    currentBlock = blocks.size() - 1;
+    offset       = 0;
+    return allocateFromCurrentBlock(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, const std::size_t bytes,
+                     const std::size_t alignment) override {
+    if (releaseMemory) {
+      releasedBytesInUse -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+  }
+
+  [[nodiscard]] bool
+  do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
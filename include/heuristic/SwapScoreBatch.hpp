@@ -0,0 +1,240 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "Architecture.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// the AVX2 kernel is compiled for the AVX2 target regardless of the flags of
+// the library and only used if the CPU supports it
+#if (defined(__GNUC__) || defined(__clang__)) &&                              \
+    (defined(__x86_64__) || defined(__i386__))
+#define SWAP_SCORE_BATCH_AVX2
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+/**
+ * Costs of logical qubit pairs sharing gates in a circuit layer before and
+ * after the candidate swaps of a search node, evaluated for all pairs and swaps
+ * in a single pass.
+ *
+ * Each entry describes one qubit pair affected by one swap by the positions of
+ * the distances of both directions in a flat row-major distance table (see
+ * `Architecture::getDistanceRow`) before and after the swap, together with the
+ * multiplicity of both directions. Entries are stored as structure of arrays,
+ * so that `evaluate` gathers the distances of several entries at once (using
+ * AVX2 if the compiler can target it and the CPU supports it).
+ *
+ * The cost of an entry is defined as in
+ * `BasicHeuristicMapper::Node::pairHeuristicCost` and computed in double
+ * precision, so that the results do not depend on the kernel.
+ */
+class SwapScoreBatch {
+  using DistanceEntry = Architecture::DistanceEntry;
+  static_assert(std::is_same_v<DistanceEntry, float>,
+                "the kernels gather single precision distances");
+
+public:
+  /** true if `evaluate` uses the AVX2 kernel (determined at startup) */
+  static inline const bool VECTORIZED = [] {
+#if defined(SWAP_SCORE_BATCH_AVX2)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+  }();
+
+  /**
+   * @brief removes all entries (keeping the allocated memory)
+   */
+  void clear() {
+    oldStraight.clear();
+    oldReverse.clear();
+    newStraight.clear();
+    newReverse.clear();
+    straightMultiplicity.clear();
+    reverseMultiplicity.clear();
+  }
+
+  /**
+   * @brief adds an entry for a qubit pair mapped to the physical qubits
+   * `oldLoc1` and `oldLoc2` before and `newLoc1` and `newLoc2` after a swap
+   *
+   * @param nqubits number of physical qubits, i.e. the row size of the
+   * distance table
+   * @param multiplicity number of gates acting on the pair in each direction
+   */
+  void add(const std::uint16_t nqubits, const std::uint16_t oldLoc1,
+           const std::uint16_t oldLoc2, const std::uint16_t newLoc1,
+           const std::uint16_t newLoc2,
+           const std::pair<std::uint16_t, std::uint16_t>& multiplicity) {
+    oldStraight.emplace_back(index(nqubits, oldLoc1, oldLoc2));
+    oldReverse.emplace_back(index(nqubits, oldLoc2, oldLoc1));
+    newStraight.emplace_back(index(nqubits, newLoc1, newLoc2));
+    newReverse.emplace_back(index(nqubits, newLoc2, newLoc1));
+    straightMultiplicity.emplace_back(multiplicity.first);
+    reverseMultiplicity.emplace_back(multiplicity.second);
+  }
+
+  [[nodiscard]] std::size_t size() const { return oldStraight.size(); }
+
+  /**
+   * @brief computes the costs of all entries before and after their swaps
+   *
+   * @param distances flat row-major distance table
+   * @param admissibleHeuristic if true, the cost of a pair is the maximum
+   * distance of both directions in use, otherwise the sum of the distances
+   * weighted by their multiplicity
+   */
+  void evaluate(const DistanceEntry* distances,
+                const bool           admissibleHeuristic) {
+    resizeCosts();
+    std::size_t i = 0;
+#if defined(SWAP_SCORE_BATCH_AVX2)
+    if (VECTORIZED) {
+      i = evaluateAvx2(distances, admissibleHeuristic);
+    }
+#endif
+    evaluatePortable(distances, admissibleHeuristic, i);
+  }
+
+  /**
+   * @brief same as `evaluate`, but always using the portable kernel
+   */
+  void evaluatePortable(const DistanceEntry* distances,
+                        const bool           admissibleHeuristic) {
+    resizeCosts();
+    evaluatePortable(distances, admissibleHeuristic, 0);
+  }
+
+  /**
+   * @brief cost of the given entry before its swap (after `evaluate`)
+   */
+  [[nodiscard]] double oldCost(const std::size_t i) const {
+    return oldCosts[i];
+  }
+
+  /**
+   * @brief cost of the given entry after its swap (after `evaluate`)
+   */
+  [[nodiscard]] double newCost(const std::size_t i) const {
+    return newCosts[i];
+  }
+
+private:
+  /** positions of the distances in the flat distance table */
+  std::vector<std::int32_t> oldStraight{};
+  std::vector<std::int32_t> oldReverse{};
+  std::vector<std::int32_t> newStraight{};
+  std::vector<std::int32_t> newReverse{};
+  std::vector<double>       straightMultiplicity{};
+  std::vector<double>       reverseMultiplicity{};
+  std::vector<double>       oldCosts{};
+  std::vector<double>       newCosts{};
+
+  [[nodiscard]] static std::int32_t index(const std::uint16_t nqubits,
+                                          const std::uint16_t from,
+                                          const std::uint16_t to) {
+    return static_cast<std::int32_t>(from) * nqubits + to;
+  }
+
+  void resizeCosts() {
+    oldCosts.resize(size());
+    newCosts.resize(size());
+  }
+
+  [[nodiscard]] static double pairCost(const double straightDistance,
+                                       const double reverseDistance,
+                                       const double straightMult,
+                                       const double reverseMult,
+                                       const bool   admissibleHeuristic) {
+    if (admissibleHeuristic) {
+      double cost = 0.;
+      if (straightMult > 0) {
+        cost = std::max(cost, straightDistance);
+      }
+      if (reverseMult > 0) {
+        cost = std::max(cost, reverseDistance);
+      }
+      return cost;
+    }
+    return straightDistance * straightMult + reverseDistance * reverseMult;
+  }
+
+  void evaluatePortable(const DistanceEntry* distances,
+                        const bool           admissibleHeuristic,
+                        const std::size_t    first) {
+    for (std::size_t i = first; i < size(); ++i) {
+      oldCosts[i] = pairCost(distances[oldStraight[i]],
+                             distances[oldReverse[i]], straightMultiplicity[i],
+                             reverseMultiplicity[i], admissibleHeuristic);
+      newCosts[i] = pairCost(distances[newStraight[i]],
+                             distances[newReverse[i]], straightMultiplicity[i],
+                             reverseMultiplicity[i], admissibleHeuristic);
+    }
+  }
+
+#if defined(SWAP_SCORE_BATCH_AVX2)
+  static constexpr std::size_t AVX2_LANES = 4;
+
+  __attribute__((target("avx2"))) static __m256d
+  gatherAvx2(const DistanceEntry* distances, const std::int32_t* indices) {
+    const auto vindex =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices)); // NOLINT
+    return _mm256_cvtps_pd(_mm_i32gather_ps(distances, vindex, 4));
+  }
+
+  __attribute__((target("avx2"))) static __m256d
+  costAvx2(const __m256d straight, const __m256d reverse,
+           const __m256d straightMult, const __m256d reverseMult,
+           const bool admissibleHeuristic) {
+    const auto zero = _mm256_setzero_pd();
+    if (admissibleHeuristic) {
+      const auto useStraight = _mm256_cmp_pd(straightMult, zero, _CMP_GT_OQ);
+      const auto useReverse  = _mm256_cmp_pd(reverseMult, zero, _CMP_GT_OQ);
+      return _mm256_max_pd(
+          _mm256_max_pd(zero, _mm256_and_pd(useStraight, straight)),
+          _mm256_and_pd(useReverse, reverse));
+    }
+    return _mm256_add_pd(_mm256_mul_pd(straight, straightMult),
+                         _mm256_mul_pd(reverse, reverseMult));
+  }
+
+  /**
+   * @brief evaluates the entries in groups of `AVX2_LANES` (distances are
+   * gathered in single and converted to double precision); only to be called
+   * if `VECTORIZED`
+   *
+   * @return the number of entries evaluated
+   */
+  __attribute__((target("avx2"))) std::size_t
+  evaluateAvx2(const DistanceEntry* distances, const bool admissibleHeuristic) {
+    std::size_t i = 0;
+    for (; i + AVX2_LANES <= size(); i += AVX2_LANES) {
+      const auto straightMult = _mm256_loadu_pd(&straightMultiplicity[i]);
+      const auto reverseMult  = _mm256_loadu_pd(&reverseMultiplicity[i]);
+      _mm256_storeu_pd(&oldCosts[i],
+                       costAvx2(gatherAvx2(distances, &oldStraight[i]),
+                                gatherAvx2(distances, &oldReverse[i]),
+                                straightMult, reverseMult,
+                                admissibleHeuristic));
+      _mm256_storeu_pd(&newCosts[i],
+                       costAvx2(gatherAvx2(distances, &newStraight[i]),
+                                gatherAvx2(distances, &newReverse[i]),
+                                straightMult, reverseMult,
+                                admissibleHeuristic));
+    }
+    return i;
+  }
+#endif
+};
@@ -0,0 +1,151 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma once
+
+/**
+ * Fixed set of worker threads that process the iterations of a loop together
+ * with the calling thread.
+ *
+ * The workers are started once and sleep between calls to `parallelFor`, so
+ * that distributing a handful of small tasks does not require spawning any
+ * threads.
+ */
+class WorkerPool {
+public:
+  /**
+   * @param nThreads total number of threads working on a loop (including the
+   * thread calling `parallelFor`), i.e. `nThreads - 1` workers are started
+   */
+  explicit WorkerPool(const std::size_t nThreads) {
+    for (std::size_t i = 1; i < nThreads; ++i) {
+      workers.emplace_back([this]() { workerLoop(); });
+    }
+  }
+
+  WorkerPool(const WorkerPool&)            = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&)                 = delete;
+  WorkerPool& operator=(WorkerPool&&)      = delete;
+
+  ~WorkerPool() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wakeUp.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief returns the total number of threads working on a loop
+   */
+  [[nodiscard]] std::size_t size() const { return workers.size() + 1; }
+
+  /**
+   * @brief calls `task(i)` for all `i` in `[0, n)` distributed over all
+   * threads and returns once all calls are finished
+   *
+   * The order in which the calls are made is unspecified. If any call throws,
+   * the first exception is rethrown after all calls are finished.
+   */
+  void parallelFor(const std::size_t                         n,
+                   const std::function<void(std::size_t)>& task) {
+    if (workers.empty() || n <= 1) {
+      for (std::size_t i = 0; i < n; ++i) {
+        task(i);
+      }
+      return;
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      currentTask   = &task;
+      nTasks        = n;
+      nextTask      = 0;
+      activeWorkers = workers.size();
+      exception     = nullptr;
+      ++generation;
+    }
+    wakeUp.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return activeWorkers == 0; });
+    currentTask = nullptr;
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+private:
+  std::vector<std::thread> workers{};
+
+  std::mutex              mutex{};
+  std::condition_variable wakeUp{};
+  std::condition_variable finished{};
+
+  /** the task of the current loop (only valid during `parallelFor`) */
+  const std::function<void(std::size_t)>* currentTask = nullptr;
+  /** number of iterations of the current loop */
+  std::size_t nTasks = 0;
+  /** next iteration of the current loop not yet claimed by any thread */
+  std::atomic<std::size_t> nextTask{0};
+  /** number of workers still working on the current loop */
+  std::size_t activeWorkers = 0;
+  /** number of loops started so far */
+  std::size_t        generation = 0;
+  bool               stop       = false;
+  std::exception_ptr exception{};
+
+  void runTasks() {
+    for (auto i = nextTask.fetch_add(1); i < nTasks;
+         i      = nextTask.fetch_add(1)) {
+      try {
+        (*currentTask)(i);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+  }
+
+  void workerLoop() {
+    std::size_t finishedGeneration = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeUp.wait(lock, [this, finishedGeneration]() {
+          return stop || generation != finishedGeneration;
+        });
+        if (stop) {
+          return;
+        }
+        finishedGeneration = generation;
+      }
+
+      runTasks();
+
+      const std::lock_guard<std::mutex> lock(mutex);
+      if (--activeWorkers == 0) {
+        finished.notify_one();
+      }
+    }
+  }
+};
@@ -185,10 +185,17 @@ Architecture::Architecture(const std::uint16_t nQ, const CouplingMap& cm,
 }
 
 void Architecture::createDistanceTable() {
-  isBidirectional = true;
+  isBidirectional     = true;
+  couplingBitsRowSize = (nqubits + 63U) / 64U;
+  couplingBits.assign(nqubits * couplingBitsRowSize, 0U);
+  neighbours.assign(nqubits, {});
   Matrix edgeWeights(nqubits, std::vector<double>(
                                   nqubits, std::numeric_limits<double>::max()));
   for (const auto& edge : couplingMap) {
+    couplingBits.at(edge.first * couplingBitsRowSize + edge.second / 64U) |=
+        std::uint64_t{1} << (edge.second % 64U);
+    neighbours.at(edge.first).emplace_back(edge.second);
+    neighbours.at(edge.second).emplace_back(edge.first);
     if (couplingMap.find({edge.second, edge.first}) == couplingMap.end()) {
       isBidirectional                            = false;
       edgeWeights.at(edge.second).at(edge.first) = COST_UNIDIRECTIONAL_SWAP;
@@ -198,8 +205,120 @@ void Architecture::createDistanceTable() {
     }
   }
 
+  for (auto& qubitNeighbours : neighbours) {
+    std::sort(qubitNeighbours.begin(), qubitNeighbours.end());
+    qubitNeighbours.erase(
+        std::unique(qubitNeighbours.begin(), qubitNeighbours.end()),
+        qubitNeighbours.end());
+  }
+
   Dijkstra::buildTable(nqubits, couplingMap, distanceTable, edgeWeights,
                        COST_DIRECTION_REVERSE, true);
+
+  teleportationDistanceTables.clear();
+  if (currentTeleportations.empty()) {
+    flattenDistanceTable(distanceTable);
+  } else {
+    createTeleportationDistanceTable(currentTeleportations,
+                                     teleportationDistanceTable);
+    flattenDistanceTable(teleportationDistanceTable);
+  }
+}
+
+void Architecture::flattenDistanceTable(const Matrix& table) {
+  flatDistanceTable.resize(static_cast<std::size_t>(nqubits) * nqubits);
+  auto it = flatDistanceTable.begin();
+  for (const auto& row : table) {
+    for (const auto dist : row) {
+      // unreachable qubits are marked by the maximum double, which is out of
+      // range for single precision
+      *it++ = dist > std::numeric_limits<DistanceEntry>::max()
+                  ? std::numeric_limits<DistanceEntry>::infinity()
+                  : static_cast<DistanceEntry>(dist);
+    }
+  }
+}
+
+void Architecture::setCurrentTeleportations(const CouplingMap& teleportations) {
+  if (teleportations == currentTeleportations) {
+    return;
+  }
+  currentTeleportations = teleportations;
+  if (currentTeleportations.empty()) {
+    flattenDistanceTable(distanceTable);
+    return;
+  }
+
+  const auto it = teleportationDistanceTables.find(currentTeleportations);
+  if (it != teleportationDistanceTables.end()) {
+    teleportationDistanceTable = it->second;
+    flattenDistanceTable(teleportationDistanceTable);
+    return;
+  }
+  createTeleportationDistanceTable(currentTeleportations,
+                                   teleportationDistanceTable);
+  flattenDistanceTable(teleportationDistanceTable);
+  if (teleportationDistanceTables.size() >= MAX_TELEPORTATION_DISTANCE_TABLES) {
+    teleportationDistanceTables.clear();
+  }
+  teleportationDistanceTables.emplace(currentTeleportations,
+                                      teleportationDistanceTable);
+}
+
+void Architecture::createTeleportationDistanceTable(
+    const CouplingMap& teleportations, Matrix& table) const {
+  // undirected adjacency of the coupling map extended by the teleportations
+  auto adjacency = neighbours;
+  for (const auto& [first, second] : teleportations) {
+    adjacency.at(first).emplace_back(second);
+    adjacency.at(second).emplace_back(first);
+  }
+
+  table.assign(nqubits, std::vector<double>(
+                            nqubits, std::numeric_limits<double>::max()));
+  std::vector<std::size_t>   hops(nqubits);
+  std::vector<bool>          forwardEdgeOnPath(nqubits);
+  std::vector<std::uint16_t> order{};
+  order.reserve(nqubits);
+  for (std::uint16_t start = 0; start < nqubits; ++start) {
+    // breadth-first search from start, additionally tracking for each qubit if
+    // any shortest path to it uses an edge of the coupling map in its
+    // direction
+    std::fill(hops.begin(), hops.end(),
+              std::numeric_limits<std::size_t>::max());
+    std::fill(forwardEdgeOnPath.begin(), forwardEdgeOnPath.end(), false);
+    order.clear();
+    hops.at(start) = 0;
+    order.emplace_back(start);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      const auto current = order[i];
+      for (const auto successor : adjacency.at(current)) {
+        if (hops.at(successor) == std::numeric_limits<std::size_t>::max()) {
+          hops.at(successor) = hops.at(current) + 1;
+          order.emplace_back(successor);
+        }
+        if (hops.at(successor) == hops.at(current) + 1 &&
+            (forwardEdgeOnPath.at(current) ||
+             isEdgeConnected({current, successor}))) {
+          forwardEdgeOnPath.at(successor) = true;
+        }
+      }
+    }
+
+    // TODO: different weight if the path contains a teleportation
+    for (const auto goal : order) {
+      const auto nrHops = static_cast<double>(hops.at(goal));
+      if (goal == start) {
+        table.at(start).at(goal) = 0.;
+      } else if (forwardEdgeOnPath.at(goal)) {
+        table.at(start).at(goal) = (nrHops - 1) * 7;
+      } else if (nrHops == 1 && !isEdgeConnected({start, goal}, false)) {
+        table.at(start).at(goal) = 7;
+      } else {
+        table.at(start).at(goal) = (nrHops - 1) * 7 + 4;
+      }
+    }
+  }
 }
 
 void Architecture::createFidelityTable() {
@@ -415,76 +534,6 @@ Architecture::getCouplingLimit(const QubitSubset& qubitChoice) const {
   return findCouplingLimit(getCouplingMap(), getNqubits(), qubitChoice);
 }
 
-std::uint64_t Architecture::bfs(const std::uint16_t   start,
-                                const std::uint16_t   goal,
-                                const std::set<Edge>& teleportations) const {
-  std::queue<std::vector<int>> queue;
-  std::vector<int>             v;
-  v.push_back(start);
-  queue.push(v);
-  std::vector<std::vector<int>> solutions;
-
-  std::uint64_t length = 0U;
-  std::set<int> successors;
-  while (!queue.empty()) {
-    v = queue.front();
-    queue.pop();
-    const int current = v[v.size() - 1];
-    if (current == goal) {
-      length = v.size();
-      solutions.push_back(v);
-      break;
-    }
-    successors.clear();
-    for (const auto& edge : getCouplingMap()) {
-      if (edge.first == current && !contains(v, edge.second)) {
-        successors.insert(edge.second);
-      }
-      if (edge.second == current && !contains(v, edge.first)) {
-        successors.insert(edge.first);
-      }
-    }
-    for (const auto& edge : teleportations) {
-      if (edge.first == current && !contains(v, edge.second)) {
-        successors.insert(edge.second);
-      }
-      if (edge.second == current && !contains(v, edge.first)) {
-        successors.insert(edge.first); // was v2 but this is probably wrong
-      }
-    }
-
-    for (const auto successor : successors) {
-      auto v2 = v;
-      v2.push_back(successor);
-      queue.push(v2);
-    }
-  }
-  while (!queue.empty() && queue.front().size() == length) {
-    if (queue.front()[queue.front().size() - 1] == goal) {
-      solutions.push_back(queue.front());
-    }
-    queue.pop();
-  }
-
-  // TODO: different weight if this contains a teleportation
-  for (const auto& s : solutions) {
-    for (std::size_t j = 0; j < s.size() - 1; j++) {
-      const Edge e{s[j], s[j + 1]};
-      if (getCouplingMap().find(e) != getCouplingMap().end()) {
-        return (length - 2) * 7;
-      }
-    }
-  }
-
-  if (length == 2 &&
-      getCouplingMap().find(Edge{start, goal}) == getCouplingMap().end() &&
-      getCouplingMap().find(Edge{goal, start}) == getCouplingMap().end()) {
-    return 7;
-  }
-
-  return (length - 2) * 7 + 4;
-}
-
 std::size_t Architecture::findCouplingLimit(const CouplingMap&  cm,
                                             const std::uint16_t nQubits) {
   std::vector<std::unordered_set<std::uint16_t>> connections;
@@ -7,6 +7,9 @@
 
 #include "CircuitOptimizer.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 void Mapper::initResults() {
   countGates(qc, results.input);
   results.input.name    = qc.getName();
@@ -19,22 +22,27 @@ void Mapper::initResults() {
 }
 
 Mapper::Mapper(const qc::QuantumComputation& quantumComputation,
-               Architecture&                 arch)
+               Architecture& arch, PreprocessedCircuit /*tag*/)
     : qc(quantumComputation.clone()), architecture(arch) {
   qubits.fill(DEFAULT_POSITION);
   locations.fill(DEFAULT_POSITION);
   fidelities.fill(INITIAL_FIDELITY);
+}
 
+Mapper::Mapper(const qc::QuantumComputation& quantumComputation,
+               Architecture&                 arch)
+    : Mapper(quantumComputation, arch, PreprocessedCircuit{}) {
   // strip away qubits that are not used in the circuit
   qc.stripIdleQubits(true, true);
   // strip away final measurement gates
   qc::CircuitOptimizer::removeFinalMeasurements(qc);
 }
 
-void Mapper::processDisjointQubitLayer(
+std::size_t Mapper::processDisjointQubitLayer(
     std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+    std::array<std::int16_t, MAX_DEVICE_QUBITS>&               lastPartner,
     const std::optional<std::uint16_t>& control, const std::uint16_t target,
-    qc::Operation* gate, bool collect2qBlocks) {
+    bool collect2qBlocks) {
   std::size_t layer = 0;
   if (!control.has_value()) {
     if (lastLayer.at(target).has_value()) {
@@ -59,39 +67,39 @@ void Mapper::processDisjointQubitLayer(
     } else {
       layer = std::max(*lastLayer.at(*control), *lastLayer.at(target)) + 1;
 
+      // each qubit is used in at most one 2Q block per layer, so the last
+      // layer contains a gate with an equivalent qubit set iff both qubits
+      // were last used together
       if (collect2qBlocks &&
-          (*lastLayer.at(*control) == *lastLayer.at(target))) {
-        for (auto& g : layers.at(layer - 1)) {
-          if ((g.control == *control && g.target == target) ||
-              (g.control == target && g.target == *control)) {
-            // if last layer contained gate with equivalent qubit set, use that
-            // layer
-            layer--;
-            break;
-          }
-        }
+          (*lastLayer.at(*control) == *lastLayer.at(target)) &&
+          lastPartner.at(*control) == static_cast<std::int16_t>(target)) {
+        // if last layer contained gate with equivalent qubit set, use that
+        // layer
+        layer--;
       }
     }
-    lastLayer.at(*control) = layer;
-    lastLayer.at(target)   = layer;
-  }
-
-  if (layers.size() <= layer) {
-    layers.emplace_back();
-  }
-  if (control.has_value()) {
-    layers.at(layer).emplace_back(*control, target, gate);
-  } else {
-    layers.at(layer).emplace_back(-1, target, gate);
+    lastLayer.at(*control)   = layer;
+    lastLayer.at(target)     = layer;
+    lastPartner.at(*control) = static_cast<std::int16_t>(target);
+    lastPartner.at(target)   = static_cast<std::int16_t>(*control);
   }
+  return layer;
 }
 
 void Mapper::createLayers() {
   const auto& config = results.config;
   std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS> lastLayer{};
+  std::array<std::int16_t, MAX_DEVICE_QUBITS>               lastPartner{};
+  lastPartner.fill(DEFAULT_POSITION);
 
   auto qubitsInLayer = std::set<std::uint16_t>{};
 
+  // the gates are first collected in circuit order together with their layer
+  // and then grouped by layer
+  std::vector<Gate>        circuitGates{};
+  std::vector<std::size_t> gateLayers{};
+  std::size_t              nlayers = 0;
+
   bool even = true;
   for (auto& gate : qc) {
     // skip over barrier instructions
@@ -122,58 +130,36 @@ void Mapper::createLayers() {
 
     // methods of layering described in
     // https://iic.jku.at/files/eda/2019_dac_mapping_quantum_circuits_ibm_architectures_using_minimal_number_swap_h_gates.pdf
+    std::size_t layer = 0;
     switch (config.layering) {
     case Layering::IndividualGates:
     case Layering::None:
       // each gate is put in a new layer
-      layers.emplace_back();
-      if (control.has_value()) {
-        layers.back().emplace_back(*control, target, gate.get());
-      } else {
-        layers.back().emplace_back(-1, target, gate.get());
-      }
+      layer = nlayers;
       break;
     case Layering::DisjointQubits:
-      processDisjointQubitLayer(lastLayer, control, target, gate.get(), false);
+      layer = processDisjointQubitLayer(lastLayer, lastPartner, control, target,
+                                        false);
       break;
     case Layering::Disjoint2qBlocks:
-      processDisjointQubitLayer(lastLayer, control, target, gate.get(), true);
+      layer = processDisjointQubitLayer(lastLayer, lastPartner, control, target,
+                                        true);
       break;
     case Layering::OddGates:
       // every other gate is put in a new layer
-      if (even) {
-        layers.emplace_back();
-        if (control.has_value()) {
-          layers.back().emplace_back(*control, target, gate.get());
-        } else {
-          layers.back().emplace_back(-1, target, gate.get());
-        }
-      } else {
-        if (control.has_value()) {
-          layers.back().emplace_back(*control, target, gate.get());
-        } else {
-          layers.back().emplace_back(-1, target, gate.get());
-        }
-      }
-      even = !even;
+      layer = even ? nlayers : nlayers - 1;
+      even  = !even;
       break;
     case Layering::QubitTriangle:
-      if (layers.empty()) {
-        layers.emplace_back();
-      }
+      layer = nlayers == 0 ? 0 : nlayers - 1;
 
-      if (singleQubit) {
-        // single qubit gates can be added in any layer
-        layers.back().emplace_back(-1, target, gate.get());
-      } else {
+      // single qubit gates can be added in any layer
+      if (!singleQubit) {
         qubitsInLayer.insert(*control);
         qubitsInLayer.insert(target);
 
-        if (qubitsInLayer.size() <= 3) {
-          layers.back().emplace_back(*control, target, gate.get());
-        } else {
-          layers.emplace_back();
-          layers.back().emplace_back(*control, target, gate.get());
+        if (qubitsInLayer.size() > 3) {
+          ++layer;
           qubitsInLayer.clear();
           qubitsInLayer.insert(*control);
           qubitsInLayer.insert(target);
@@ -181,21 +167,116 @@ void Mapper::createLayers() {
       }
       break;
     }
+
+    if (control.has_value()) {
+      circuitGates.emplace_back(*control, target, gate.get());
+    } else {
+      circuitGates.emplace_back(-1, target, gate.get());
+    }
+    gateLayers.emplace_back(layer);
+    nlayers = std::max(nlayers, layer + 1);
   }
+
+  layers.assign(std::move(circuitGates), gateLayers, nlayers);
   results.input.layers = layers.size();
+  createNextTwoQubitLayerIndex();
 }
 
-std::size_t Mapper::getNextLayer(std::size_t idx) {
-  auto next = idx + 1;
-  while (next < layers.size()) {
-    for (const auto& gate : layers.at(next)) {
-      if (!gate.singleQubit()) {
-        return next;
+void Mapper::createNextTwoQubitLayerIndex() {
+  nextTwoQubitLayer.assign(layers.size() + 1,
+                           std::numeric_limits<std::size_t>::max());
+  for (std::size_t i = layers.size(); i-- > 0;) {
+    if (layers.hasTwoQubitGates(i)) {
+      nextTwoQubitLayer[i] = i;
+    } else {
+      nextTwoQubitLayer[i] = nextTwoQubitLayer[i + 1];
+    }
+  }
+}
+
+void Mapper::Layers::assign(std::vector<Gate>               circuitGates,
+                            const std::vector<std::size_t>& gateLayers,
+                            const std::size_t               nlayers) {
+  clear();
+
+  std::size_t ntwoQubitGates = 0;
+  offsets.assign(nlayers + 1, 0);
+  for (std::size_t i = 0; i < circuitGates.size(); ++i) {
+    ++offsets[gateLayers[i] + 1];
+    if (!circuitGates[i].singleQubit()) {
+      ++ntwoQubitGates;
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  if (std::is_sorted(gateLayers.begin(), gateLayers.end())) {
+    // the gates are already grouped by layer
+    gates = std::move(circuitGates);
+  } else {
+    // stable counting sort of the gates by their layer
+    gates.assign(circuitGates.size(), Gate{-1, 0});
+    std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < circuitGates.size(); ++i) {
+      gates[next[gateLayers[i]]++] = circuitGates[i];
+    }
+  }
+
+  twoQubit.reserve(ntwoQubitGates);
+  twoQubitOffsets.reserve(nlayers + 1);
+  multiplicities.reserve(ntwoQubitGates);
+  multiplicityOffsets.reserve(nlayers + 1);
+  for (std::size_t layer = 0; layer < nlayers; ++layer) {
+    const auto first = multiplicities.size();
+    for (auto i = offsets[layer]; i < offsets[layer + 1]; ++i) {
+      const auto& gate = gates[i];
+      if (gate.singleQubit()) {
+        continue;
       }
+      twoQubit.emplace_back(gate);
+
+      const auto control = static_cast<std::uint16_t>(gate.control);
+      if (control >= gate.target) {
+        multiplicities.push_back({{gate.target, control}, {0, 1}});
+      } else {
+        multiplicities.push_back({{control, gate.target}, {1, 0}});
+      }
+    }
+    twoQubitOffsets.emplace_back(twoQubit.size());
+
+    // merge the entries of equal qubit pairs
+    std::sort(multiplicities.begin() + static_cast<std::ptrdiff_t>(first),
+              multiplicities.end());
+    auto last = first;
+    for (auto i = first + 1; i < multiplicities.size(); ++i) {
+      if (multiplicities[i].first == multiplicities[last].first) {
+        multiplicities[last].second.first += multiplicities[i].second.first;
+        multiplicities[last].second.second += multiplicities[i].second.second;
+      } else {
+        multiplicities[++last] = multiplicities[i];
+      }
+    }
+    if (first < multiplicities.size()) {
+      multiplicities.resize(last + 1);
     }
-    next++;
+    multiplicityOffsets.emplace_back(multiplicities.size());
+  }
+  multiplicities.shrink_to_fit();
+}
+
+void Mapper::Layers::clear() {
+  gates.clear();
+  offsets.assign(1, 0);
+  twoQubit.clear();
+  twoQubitOffsets.assign(1, 0);
+  multiplicities.clear();
+  multiplicityOffsets.assign(1, 0);
+}
+
+std::size_t Mapper::getNextLayer(std::size_t idx) {
+  if (idx >= layers.size()) {
+    return std::numeric_limits<std::size_t>::max();
   }
-  return std::numeric_limits<std::size_t>::max();
+  return nextTwoQubitLayer.at(idx + 1);
 }
 
 void Mapper::finalizeMappedCircuit() {
@@ -23,6 +23,33 @@ nlohmann::json Configuration::json() const {
     heuristic["initial_layout"]       = ::toString(initialLayout);
     heuristic["admissible_heuristic"] = admissibleHeuristic;
     heuristic["consider_fidelity"]    = considerFidelity;
+    heuristic["search_algorithm"]     = ::toString(searchAlgorithm);
+    heuristic["n_threads"]            = nThreads;
+    if (memoryLimit > 0) {
+      heuristic["memory_limit"] = memoryLimit;
+    }
+    if (pruneCommutingSwaps) {
+      heuristic["prune_commuting_swaps"] = pruneCommutingSwaps;
+    }
+    if (swapCountBound) {
+      heuristic["swap_count_bound"] = swapCountBound;
+    }
+    if (usePatternDatabase) {
+      heuristic["use_pattern_database"] = usePatternDatabase;
+      if (!patternDatabaseDirectory.empty()) {
+        heuristic["pattern_database_directory"] = patternDatabaseDirectory;
+      }
+    }
+    if (cacheLayerSolutions) {
+      heuristic["cache_layer_solutions"] = cacheLayerSolutions;
+    }
+    if (searchAlgorithm == SearchAlgorithm::AnytimeAStar) {
+      auto& anytime                        = heuristic["anytime"];
+      anytime["heuristic_weight"]          = heuristicWeight;
+      anytime["heuristic_weight_decrease"] = heuristicWeightDecrease;
+      anytime["layer_timeout"]             = layerTimeout;
+      anytime["timeout"]                   = timeout;
+    }
     if (lookahead) {
       auto& lookaheadSettings           = heuristic["lookahead"];
       lookaheadSettings["lookaheads"]   = nrLookaheads;
@@ -25,19 +25,9 @@ void ExactMapper::map(const Configuration& settings) {
   if (config.verbose) {
     printLayering(std::cout);
   }
-  std::size_t k = 0;
-  for (const auto& layer : layers) {
-    bool onlySingleQubit = true;
-    for (const auto& gate : layer) {
-      if (!gate.singleQubit()) {
-        onlySingleQubit = false;
-        break;
-      }
-    }
-    if (!onlySingleQubit) {
-      reducedLayerIndices.emplace_back(k);
-    }
-    ++k;
+  for (auto k = nextTwoQubitLayer.front();
+       k != std::numeric_limits<std::size_t>::max(); k = getNextLayer(k)) {
+    reducedLayerIndices.emplace_back(k);
   }
 
   // quickly terminate if the circuit only contains single-qubit gates
@@ -284,11 +274,9 @@ void ExactMapper::map(const Configuration& settings) {
         const Edge cnot = {locations.at(static_cast<std::size_t>(gate.control)),
                            locations.at(gate.target)};
 
-        if (architecture.getCouplingMap().find(cnot) ==
-            architecture.getCouplingMap().end()) {
+        if (!architecture.isEdgeConnected(cnot)) {
           const Edge reverse = {cnot.second, cnot.first};
-          if (architecture.getCouplingMap().find(reverse) ==
-              architecture.getCouplingMap().end()) {
+          if (!architecture.isEdgeConnected(reverse)) {
             throw QMAPException(
                 "Invalid CNOT: " + std::to_string(reverse.first) + "-" +
                 std::to_string(reverse.second));
@@ -588,11 +576,7 @@ number of variables: (|L|-1) * m!
   //////////////////////////////////////////
   for (std::size_t k = 0; k < reducedLayerIndices.size(); ++k) {
     auto allCouplings = LogicTerm(true);
-    for (const auto& gate : layers.at(reducedLayerIndices.at(k))) {
-      if (gate.singleQubit()) {
-        continue;
-      }
-
+    for (const auto& gate : layers.twoQubitGates(reducedLayerIndices.at(k))) {
       auto coupling = LogicTerm(false);
       if (architecture.bidirectional()) {
         for (const auto& edge : rcm) {
@@ -730,11 +714,7 @@ number of variables: (|L|-1) * m!
   if (!architecture.bidirectional()) {
     const auto numLayers = reducedLayerIndices.size();
     for (std::size_t k = 0; k < numLayers; ++k) {
-      for (const auto& gate : layers.at(reducedLayerIndices.at(k))) {
-        if (gate.singleQubit()) {
-          continue;
-        }
-
+      for (const auto& gate : layers.twoQubitGates(reducedLayerIndices.at(k))) {
         auto reverse = LogicTerm(false);
         for (const auto& [q0, q1] : rcm) {
           const auto indexFT = x[k][physicalQubitIndex[q0]][gate.target];
@@ -832,10 +812,8 @@ number of variables: (|L|-1) * m!
     // direction reverse
     if (!architecture.bidirectional()) {
       for (std::size_t k = 0; k < reducedLayerIndices.size(); ++k) {
-        for (const auto& gate : layers.at(reducedLayerIndices.at(k))) {
-          if (gate.singleQubit()) {
-            continue;
-          }
+        for (const auto& gate :
+             layers.twoQubitGates(reducedLayerIndices.at(k))) {
           for (const auto& edge : rcm) {
             auto indexFT = x[k][physicalQubitIndex[edge.first]][gate.target];
             auto indexSC = x[k][physicalQubitIndex[edge.second]]
@@ -5,20 +5,60 @@
 
 #include "heuristic/HeuristicMapper.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 
-void HeuristicMapper::map(const Configuration& configuration) {
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::map(const Configuration& configuration) {
   results        = MappingResults{};
   results.config = configuration;
   auto& config   = results.config;
+  teleportationLocations.reset();
+  if (config.nThreads <= 1) {
+    workerPool.reset();
+  } else if (workerPool == nullptr || workerPool->size() != config.nThreads) {
+    workerPool = std::make_unique<WorkerPool>(config.nThreads);
+  }
   if (config.layering == Layering::OddGates ||
       config.layering == Layering::QubitTriangle) {
     std::cerr << "Layering strategy " << toString(config.layering)
               << " not suitable for heuristic mapper!" << std::endl;
     return;
   }
+  if (config.searchAlgorithm == SearchAlgorithm::HDAStar &&
+      config.teleportationQubits > 0) {
+    std::cerr << "Teleportation is not supported by HDA* search!" << std::endl;
+    return;
+  }
+  if (config.admissibleHeuristic && config.usePatternDatabase &&
+      (patternDatabase == nullptr || !patternDatabase->matches(architecture))) {
+    patternDatabase = PatternDatabase::loadOrCreate(
+        architecture, config.patternDatabaseDirectory);
+  }
+  if (config.cacheLayerSolutions) {
+    if (layerCache == nullptr) {
+      layerCache = std::make_shared<LayerCache>();
+    }
+    layerCache->validate(PatternDatabase::couplingMapHash(architecture),
+                         layerCacheConfiguration(config));
+  }
   const auto start = std::chrono::steady_clock::now();
+  mappingDeadline  = config.timeout > 0
+                         ? start + std::chrono::milliseconds(config.timeout)
+                         : std::chrono::steady_clock::time_point::max();
   initResults();
+  results.timeout = false;
+  // only an admissible heuristic without lookahead yields lower bounds of the
+  // optimal cost (see `anytimeAStarMap`)
+  results.suboptimalityBound.reset();
+  if (config.searchAlgorithm == SearchAlgorithm::AnytimeAStar &&
+      config.admissibleHeuristic && !config.lookahead) {
+    results.suboptimalityBound = 1.;
+  }
 
   // perform pre-mapping optimizations
   preMappingOptimizations(config);
@@ -41,8 +81,9 @@ void HeuristicMapper::map(const Configuration& configuration) {
   for (std::size_t i = 0; i < layers.size(); ++i) {
     const Node result = aStarMap(i);
 
-    qubits    = result.qubits;
-    locations = result.locations;
+    std::copy(result.qubits.begin(), result.qubits.end(), qubits.begin());
+    std::copy(result.locations.begin(), result.locations.end(),
+              locations.begin());
 
     if (config.verbose) {
       printLocations(std::clog);
@@ -51,38 +92,33 @@ void HeuristicMapper::map(const Configuration& configuration) {
 
     // initial layer needs no swaps
     if (i != 0) {
-      for (const auto& swaps : result.swaps) {
-        for (const auto& swap : swaps) {
-          if (swap.op == qc::SWAP) {
-            if (config.verbose) {
-              std::clog << "SWAP: " << swap.first << " <-> " << swap.second
-                        << "\n";
-            }
-            if (architecture.getCouplingMap().find({swap.first, swap.second}) ==
-                    architecture.getCouplingMap().end() &&
-                architecture.getCouplingMap().find({swap.second, swap.first}) ==
-                    architecture.getCouplingMap().end()) {
-              throw QMAPException(
-                  "Invalid SWAP: " + std::to_string(swap.first) + "<->" +
-                  std::to_string(swap.second));
-            }
-            qcMapped.swap(swap.first, swap.second);
-            results.output.swaps++;
-          } else if (swap.op == qc::Teleportation) {
-            if (config.verbose) {
-              std::clog << "TELE: " << swap.first << " <-> " << swap.second
-                        << "\n";
-            }
-            qcMapped.emplace_back<qc::StandardOperation>(
-                qcMapped.getNqubits(),
-                qc::Targets{static_cast<qc::Qubit>(swap.first),
-                            static_cast<qc::Qubit>(swap.second),
-                            static_cast<qc::Qubit>(swap.middleAncilla)},
-                qc::Teleportation);
-            results.output.teleportations++;
+      for (const auto& swap : result.getSwaps()) {
+        if (swap.op == qc::SWAP) {
+          if (config.verbose) {
+            std::clog << "SWAP: " << swap.first << " <-> " << swap.second
+                      << "\n";
           }
-          gateidx++;
+          if (!architecture.isEdgeConnected({swap.first, swap.second},
+                                            false)) {
+            throw QMAPException("Invalid SWAP: " + std::to_string(swap.first) +
+                                "<->" + std::to_string(swap.second));
+          }
+          qcMapped.swap(swap.first, swap.second);
+          results.output.swaps++;
+        } else if (swap.op == qc::Teleportation) {
+          if (config.verbose) {
+            std::clog << "TELE: " << swap.first << " <-> " << swap.second
+                      << "\n";
+          }
+          qcMapped.emplace_back<qc::StandardOperation>(
+              qcMapped.getNqubits(),
+              qc::Targets{static_cast<qc::Qubit>(swap.first),
+                          static_cast<qc::Qubit>(swap.second),
+                          static_cast<qc::Qubit>(swap.middleAncilla)},
+              qc::Teleportation);
+          results.output.teleportations++;
         }
+        gateidx++;
       }
     }
 
@@ -112,11 +148,9 @@ void HeuristicMapper::map(const Configuration& configuration) {
         const Edge cnot = {
             locations.at(static_cast<std::uint16_t>(gate.control)),
             locations.at(gate.target)};
-        if (architecture.getCouplingMap().find(cnot) ==
-            architecture.getCouplingMap().end()) {
+        if (!architecture.isEdgeConnected(cnot)) {
           const Edge reverse = {cnot.second, cnot.first};
-          if (architecture.getCouplingMap().find(reverse) ==
-              architecture.getCouplingMap().end()) {
+          if (!architecture.isEdgeConnected(reverse)) {
             throw QMAPException(
                 "Invalid CNOT: " + std::to_string(reverse.first) + "-" +
                 std::to_string(reverse.second));
@@ -235,15 +269,11 @@ void HeuristicMapper::map(const Configuration& configuration) {
   const auto                          end  = std::chrono::steady_clock::now();
   const std::chrono::duration<double> diff = end - start;
   results.time                             = diff.count();
-  results.timeout                          = false;
 }
 
-void HeuristicMapper::staticInitialMapping() {
-  for (const auto& gate : layers.at(0U)) {
-    if (gate.singleQubit()) {
-      continue;
-    }
-
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::staticInitialMapping() {
+  for (const auto& gate : layers.twoQubitGates(0U)) {
     for (const auto& [q0, q1] : architecture.getCouplingMap()) {
       if (qubits.at(q0) == DEFAULT_POSITION &&
           qubits.at(q1) == DEFAULT_POSITION) {
@@ -278,7 +308,8 @@ void HeuristicMapper::staticInitialMapping() {
   }
 }
 
-void HeuristicMapper::createInitialMapping() {
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::createInitialMapping() {
   auto& config = results.config;
 
   if (layers.empty()) {
@@ -343,7 +374,8 @@ void HeuristicMapper::createInitialMapping() {
   }
 }
 
-void HeuristicMapper::mapUnmappedGates(
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::mapUnmappedGates(
     const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
   for (const auto& [logEdge, _] : twoQubitGateMultiplicity) {
     const auto& [q1, q2] = logEdge;
@@ -403,8 +435,9 @@ void HeuristicMapper::mapUnmappedGates(
   }
 }
 
-void HeuristicMapper::mapToMinDistance(const std::uint16_t source,
-                                       const std::uint16_t target) {
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::mapToMinDistance(
+    const std::uint16_t source, const std::uint16_t target) {
   auto                         min = std::numeric_limits<double>::max();
   std::optional<std::uint16_t> pos = std::nullopt;
   for (std::uint16_t i = 0; i < architecture.getNqubits(); ++i) {
@@ -425,221 +458,1007 @@ void HeuristicMapper::mapToMinDistance(const std::uint16_t source,
   qc::QuantumComputation::findAndSWAP(target, *pos, qcMapped.outputPermutation);
 }
 
-HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer) {
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::aStarMap(size_t layer) {
   std::unordered_set<std::uint16_t> consideredQubits{};
   Node                              node{};
-  TwoQubitMultiplicity              twoQubitGateMultiplicity{};
-
-  for (const auto& gate : layers.at(layer)) {
-    if (!gate.singleQubit()) {
-      consideredQubits.emplace(gate.control);
-      consideredQubits.emplace(gate.target);
-      if (gate.control >= gate.target) {
-        const auto edge =
-            std::pair(gate.target, static_cast<std::uint16_t>(gate.control));
-        if (twoQubitGateMultiplicity.find(edge) ==
-            twoQubitGateMultiplicity.end()) {
-          twoQubitGateMultiplicity[edge] = {0, 1};
-        } else {
-          twoQubitGateMultiplicity[edge].second++;
-        }
-      } else {
-        const auto edge =
-            std::pair(static_cast<std::uint16_t>(gate.control), gate.target);
-        if (twoQubitGateMultiplicity.find(edge) ==
-            twoQubitGateMultiplicity.end()) {
-          twoQubitGateMultiplicity[edge] = {1, 0};
-        } else {
-          twoQubitGateMultiplicity[edge].first++;
-        }
-      }
-    }
+
+  const auto twoQubitGateMultiplicity = layers.twoQubitMultiplicity(layer);
+  for (const auto& gate : layers.twoQubitGates(layer)) {
+    consideredQubits.emplace(gate.control);
+    consideredQubits.emplace(gate.target);
   }
 
   mapUnmappedGates(twoQubitGateMultiplicity);
-
-  node.locations = locations;
-  node.qubits    = qubits;
+  const auto multiplicityIndex =
+      createMultiplicityIndex(twoQubitGateMultiplicity);
+  const auto lookaheadWindow = results.config.lookahead
+                                   ? createLookaheadWindow(layer)
+                                   : LookaheadWindow{};
+
+  std::copy_n(locations.begin(), Capacity, node.locations.begin());
+  std::copy_n(qubits.begin(), Capacity, node.qubits.begin());
+  node.recalculateHash();
   node.recalculateFixedCost(architecture);
   node.updateHeuristicCost(architecture, twoQubitGateMultiplicity,
-                           results.config.admissibleHeuristic);
-
-  nodes.push(node);
+                           results.config.admissibleHeuristic,
+                           useSwapCountBound(), activePatternDatabase());
 
   const auto& debug = results.config.debug;
   const auto  start = std::chrono::steady_clock::now();
-  if (debug) {
-    results.layerHeuristicBenchmark.emplace_back();
-  }
-  auto& totalExpandedNodes = results.heuristicBenchmark.expandedNodes;
-  auto  layerResultsIt     = results.layerHeuristicBenchmark.rbegin();
 
-  while (!nodes.top().done) {
-    Node current = nodes.top();
-    nodes.pop();
-    expandNode(consideredQubits, current, layer, twoQubitGateMultiplicity);
+  // the result of the previous layer is no longer needed
+  resetSearchArena();
 
-    if (debug) {
-      ++totalExpandedNodes;
-      ++layerResultsIt->expandedNodes;
+  MappingResults::HeuristicBenchmarkInfo layerResults{};
+  Node                                   result{};
+
+  // solutions of previous layers can only be replayed with plain swaps
+  std::optional<LayerCache::Key>    cacheKey{};
+  std::optional<std::vector<Edge>> cachedSwaps{};
+  if (results.config.cacheLayerSolutions &&
+      results.config.teleportationQubits == 0) {
+    cacheKey = createLayerCacheKey(layer, twoQubitGateMultiplicity);
+    if (cacheKey.has_value()) {
+      cachedSwaps = layerCache->find(*cacheKey);
+    }
+  }
+
+  if (cachedSwaps.has_value()) {
+    result = replaySwaps(node, *cachedSwaps, lookaheadWindow,
+                         twoQubitGateMultiplicity);
+    ++layerResults.layerCacheHits;
+  } else if (results.config.searchAlgorithm == SearchAlgorithm::HDAStar) {
+    result = hdaStarMap(node, consideredQubits, lookaheadWindow,
+                        twoQubitGateMultiplicity, multiplicityIndex,
+                        layerResults);
+  } else if (results.config.searchAlgorithm == SearchAlgorithm::IDAStar) {
+    result = idaStarMap(node, consideredQubits, lookaheadWindow,
+                        twoQubitGateMultiplicity, multiplicityIndex,
+                        layerResults);
+  } else if (results.config.searchAlgorithm == SearchAlgorithm::PEAStar) {
+    result = peaStarMap(node, consideredQubits, lookaheadWindow,
+                        twoQubitGateMultiplicity, multiplicityIndex,
+                        layerResults);
+  } else if (results.config.searchAlgorithm ==
+             SearchAlgorithm::AnytimeAStar) {
+    result = anytimeAStarMap(node, consideredQubits, lookaheadWindow,
+                             twoQubitGateMultiplicity, multiplicityIndex,
+                             layerResults);
+  } else {
+    // nodes dropped since their mapping was expanded in the meantime
+    std::size_t closedNodesSkipped = 0;
+    // see `memoryLimitExpansionBound` (set once nodes have been pruned)
+    std::optional<std::size_t> maxExpandedNodes{};
+    nodes.push(node);
+    while (!nodes.top().done) {
+      if (maxExpandedNodes.has_value() &&
+          layerResults.expandedNodes >= *maxExpandedNodes) {
+        break;
+      }
+      Node current = nodes.top();
+      nodes.pop();
+      const auto [closed, inserted] = closedNodes.try_emplace(
+          ClosedMapping{current.hash, current.qubits}, current.costFixed);
+      if (!inserted) {
+        if (closed->second <= current.costFixed) {
+          ++closedNodesSkipped;
+          continue;
+        }
+        closed->second = current.costFixed;
+        ++layerResults.reExpandedNodes;
+      }
+      expandNode(consideredQubits, current, lookaheadWindow,
+                 twoQubitGateMultiplicity, multiplicityIndex);
+      ++layerResults.expandedNodes;
+      const auto prunedNodes = pruneOpenList(
+          nodes, results.config.memoryLimit, evictClosedNodes());
+      layerResults.prunedNodes += prunedNodes;
+      if (prunedNodes > 0 && !maxExpandedNodes.has_value()) {
+        maxExpandedNodes = memoryLimitExpansionBound(
+            layerResults.expandedNodes, nodes.size());
+      }
+    }
+    const bool abandoned = !nodes.top().done;
+    if (!abandoned) {
+      result = nodes.top();
+    }
+    layerResults.generatedNodes = layerResults.expandedNodes +
+                                  layerResults.prunedNodes +
+                                  closedNodesSkipped + nodes.size();
+
+    nodes.clear();
+    if (abandoned) {
+      ClosedSet(&searchArena).swap(closedNodes);
+      result = idaStarMap(node, consideredQubits, lookaheadWindow,
+                          twoQubitGateMultiplicity, multiplicityIndex,
+                          layerResults);
+    }
+  }
+  // the memory of `searchArena` is reused by the search of the next layer
+  result.detachSwaps();
+
+  if (cacheKey.has_value() && !cachedSwaps.has_value()) {
+    ++layerResults.layerCacheMisses;
+    // solutions of searches cut short by a limit may be worse than the ones
+    // found without it
+    const bool complete =
+        results.config.searchAlgorithm == SearchAlgorithm::AnytimeAStar
+            ? !anytimeSearchExpired
+            : layerResults.prunedNodes == 0;
+    if (result.done && complete) {
+      std::vector<Edge> swaps{};
+      for (const auto& swap : result.getSwaps()) {
+        swaps.emplace_back(swap.first, swap.second);
+      }
+      layerCache->insert(std::move(*cacheKey), std::move(swaps));
     }
   }
+  results.heuristicBenchmark.layerCacheHits += layerResults.layerCacheHits;
+  results.heuristicBenchmark.layerCacheMisses += layerResults.layerCacheMisses;
 
-  Node result = nodes.top();
   if (debug) {
     const auto end = std::chrono::steady_clock::now();
 
-    layerResultsIt->solutionDepth = result.depth;
+    layerResults.solutionDepth = result.depth;
+    results.heuristicBenchmark.expandedNodes += layerResults.expandedNodes;
+    results.heuristicBenchmark.generatedNodes += layerResults.generatedNodes;
+    results.heuristicBenchmark.prunedNodes += layerResults.prunedNodes;
+    results.heuristicBenchmark.reExpandedNodes += layerResults.reExpandedNodes;
 
     const std::chrono::duration<double> diff = end - start;
     results.heuristicBenchmark.timePerNode += diff.count();
 
-    layerResultsIt->generatedNodes =
-        layerResultsIt->expandedNodes + nodes.size();
-    results.heuristicBenchmark.generatedNodes += layerResultsIt->generatedNodes;
+    if (layerResults.expandedNodes > 0) {
+      layerResults.timePerNode =
+          diff.count() / static_cast<double>(layerResults.expandedNodes);
+      layerResults.averageBranchingFactor =
+          static_cast<double>(layerResults.generatedNodes - 1) /
+          static_cast<double>(layerResults.expandedNodes);
+    }
+
+    layerResults.effectiveBranchingFactor = computeEffectiveBranchingRate(
+        layerResults.expandedNodes + 1, result.depth);
+    results.layerHeuristicBenchmark.emplace_back(layerResults);
+  }
+
+  return result;
+}
+
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::idaStarMap(
+    const Node& root, const std::unordered_set<std::uint16_t>& consideredQubits,
+    const LookaheadWindow&                  lookaheadWindow,
+    const TwoQubitMultiplicity&             twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex&        multiplicityIndex,
+    MappingResults::HeuristicBenchmarkInfo& layerResults) {
+  const auto& config = results.config;
+
+  const auto tableSize =
+      config.memoryLimit > 0
+          ? std::max<std::size_t>(1, config.memoryLimit /
+                                         sizeof(TranspositionEntry))
+          : DEFAULT_TRANSPOSITION_TABLE_SIZE;
+  if (transpositionTable.size() != tableSize) {
+    transpositionTable.assign(tableSize, TranspositionEntry{});
+  }
 
-    if (layerResultsIt->expandedNodes > 0) {
-      layerResultsIt->timePerNode =
-          diff.count() / static_cast<double>(layerResultsIt->expandedNodes);
-      layerResultsIt->averageBranchingFactor =
-          static_cast<double>(layerResultsIt->generatedNodes - 1) /
-          static_cast<double>(layerResultsIt->expandedNodes);
+  double bound     = root.getTotalCost();
+  double nextBound = 0.;
+
+  // depth-first search of all nodes with a total cost not exceeding `bound`,
+  // returning the first goal node found
+  const auto search = [&](const auto& self,
+                          const Node& node) -> std::optional<Node> {
+    const auto cost = node.getTotalCost();
+    if (cost > bound + IDA_STAR_BOUND_TOLERANCE) {
+      nextBound = std::min(nextBound, cost);
+      return std::nullopt;
+    }
+    if (node.done) {
+      return node;
     }
 
-    layerResultsIt->effectiveBranchingFactor = computeEffectiveBranchingRate(
-        layerResultsIt->expandedNodes + 1, result.depth);
+    // the subtree of a mapping reached before with at most the same cost has
+    // already been searched with at least the same remaining budget
+    auto& entry = transpositionTable[node.hash % transpositionTable.size()];
+    if (entry.iteration == transpositionIteration && entry.hash == node.hash &&
+        entry.costFixed <= node.costFixed + IDA_STAR_BOUND_TOLERANCE) {
+      return std::nullopt;
+    }
+    entry = {node.hash, transpositionIteration, node.costFixed};
+
+    auto children = createChildNodes(consideredQubits, node, lookaheadWindow,
+                                     twoQubitGateMultiplicity,
+                                     multiplicityIndex);
+    ++layerResults.expandedNodes;
+    layerResults.generatedNodes += children.size();
+
+    // visit the most promising children first
+    std::sort(children.begin(), children.end(),
+              [](const Node& x, const Node& y) { return y > x; });
+    for (const auto& child : children) {
+      if (auto goal = self(self, child)) {
+        return goal;
+      }
+    }
+    return std::nullopt;
+  };
+
+  ++layerResults.generatedNodes;
+  while (true) {
+    // invalidates all entries of the transposition table
+    ++transpositionIteration;
+    nextBound = std::numeric_limits<double>::infinity();
+    if (auto goal = search(search, root)) {
+      return *goal;
+    }
+    if (nextBound == std::numeric_limits<double>::infinity()) {
+      throw QMAPException("IDA* search terminated without finding a mapping.");
+    }
+    bound = nextBound;
   }
+}
+
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::anytimeAStarMap(
+    const Node& root, const std::unordered_set<std::uint16_t>& consideredQubits,
+    const LookaheadWindow&                  lookaheadWindow,
+    const TwoQubitMultiplicity&             twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex&        multiplicityIndex,
+    MappingResults::HeuristicBenchmarkInfo& layerResults) {
+  const auto& config = results.config;
 
-  // clear nodes
-  while (!nodes.empty()) {
-    nodes.pop();
+  auto deadline = mappingDeadline;
+  if (config.layerTimeout > 0) {
+    deadline = std::min(deadline,
+                        std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(config.layerTimeout));
   }
 
-  return result;
+  std::optional<Node> incumbent{};
+  auto                incumbentCost = std::numeric_limits<double>::infinity();
+  auto                lowerBound    = root.getTotalCost();
+  auto                weight        = std::max(1., config.heuristicWeight);
+  bool                expired       = false;
+
+  while (true) {
+    WeightedOpenList open{WeightedNodeCompare{weight}, &searchArena};
+    open.push(root);
+    ++layerResults.generatedNodes;
+
+    while (!open.empty()) {
+      if (incumbent.has_value() &&
+          std::chrono::steady_clock::now() >= deadline) {
+        expired = true;
+        break;
+      }
+      Node current = open.top();
+      open.pop();
+      if (current.getTotalCost() >= incumbentCost - ANYTIME_COST_TOLERANCE) {
+        ++layerResults.prunedNodes;
+        continue;
+      }
+      if (current.done) {
+        incumbent     = current;
+        incumbentCost = current.getTotalCost();
+        break;
+      }
+
+      auto children = createChildNodes(
+          consideredQubits, current, lookaheadWindow, twoQubitGateMultiplicity,
+          multiplicityIndex, &searchArena);
+      ++layerResults.expandedNodes;
+      layerResults.generatedNodes += children.size();
+      for (const auto& child : children) {
+        if (child.getTotalCost() >= incumbentCost - ANYTIME_COST_TOLERANCE) {
+          ++layerResults.prunedNodes;
+        } else {
+          open.push(child);
+        }
+      }
+    }
+
+    if (!incumbent.has_value()) {
+      throw QMAPException(
+          "Anytime A* search terminated without finding a mapping.");
+    }
+
+    // every cheaper mapping descends from one of the remaining open nodes
+    auto runBound = incumbentCost;
+    open.forEach([&runBound](const Node& node) {
+      runBound = std::min(runBound, node.getTotalCost());
+    });
+    lowerBound = std::max(lowerBound, runBound);
+
+    if (expired || lowerBound >= incumbentCost - ANYTIME_COST_TOLERANCE ||
+        weight <= 1. || config.heuristicWeightDecrease <= 0.) {
+      break;
+    }
+    weight = std::max(1., weight - config.heuristicWeightDecrease);
+  }
+
+  if (results.suboptimalityBound.has_value() &&
+      lowerBound < incumbentCost - ANYTIME_COST_TOLERANCE) {
+    results.suboptimalityBound =
+        std::max(*results.suboptimalityBound, incumbentCost / lowerBound);
+  }
+  if (expired) {
+    results.timeout = true;
+  }
+  anytimeSearchExpired = expired;
+  return *incumbent;
 }
 
-void HeuristicMapper::expandNode(
-    const std::unordered_set<std::uint16_t>& consideredQubits, Node& node,
-    std::size_t layer, const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
-  std::vector<std::vector<bool>> usedSwaps;
-  usedSwaps.reserve(architecture.getNqubits());
-  for (int p = 0; p < architecture.getNqubits(); ++p) {
-    usedSwaps.emplace_back(architecture.getNqubits());
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::peaStarMap(
+    const Node& root, const std::unordered_set<std::uint16_t>& consideredQubits,
+    const LookaheadWindow&                  lookaheadWindow,
+    const TwoQubitMultiplicity&             twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex&        multiplicityIndex,
+    MappingResults::HeuristicBenchmarkInfo& layerResults) {
+  PartialExpansionOpenList open{&searchArena};
+  open.push(root);
+  ++layerResults.generatedNodes;
+
+  // see `memoryLimitExpansionBound` (set once nodes have been pruned)
+  std::optional<std::size_t> maxExpandedNodes{};
+  while (!open.top().done) {
+    if (maxExpandedNodes.has_value() &&
+        layerResults.expandedNodes >= *maxExpandedNodes) {
+      open.clear();
+      return idaStarMap(root, consideredQubits, lookaheadWindow,
+                        twoQubitGateMultiplicity, multiplicityIndex,
+                        layerResults);
+    }
+    Node current = open.top();
+    open.pop();
+
+    const auto children =
+        createChildNodes(consideredQubits, current, lookaheadWindow,
+                         twoQubitGateMultiplicity, multiplicityIndex,
+                         &searchArena);
+    const auto storedCost    = current.getStoredCost();
+    const bool reExpansion   = current.nextChildCost > 0.;
+    auto       nextChildCost = std::numeric_limits<double>::infinity();
+    for (const auto& child : children) {
+      const auto cost = child.getTotalCost();
+      if (cost > storedCost + PARTIAL_EXPANSION_COST_TOLERANCE) {
+        nextChildCost = std::min(nextChildCost, cost);
+      } else if (!reExpansion ||
+                 cost >= storedCost - PARTIAL_EXPANSION_COST_TOLERANCE) {
+        // children cheaper than the stored cost of a re-expanded node have
+        // already been added in an earlier expansion
+        open.push(child);
+      }
+    }
+    if (!reExpansion) {
+      layerResults.generatedNodes += children.size();
+    }
+    ++layerResults.expandedNodes;
+
+    if (nextChildCost != std::numeric_limits<double>::infinity()) {
+      current.nextChildCost = nextChildCost;
+      open.push(current);
+    }
+    const auto prunedNodes = pruneOpenList(open, results.config.memoryLimit);
+    layerResults.prunedNodes += prunedNodes;
+    if (prunedNodes > 0 && !maxExpandedNodes.has_value()) {
+      maxExpandedNodes =
+          memoryLimitExpansionBound(layerResults.expandedNodes, open.size());
+    }
+  }
+  return open.top();
+}
+
+template <std::uint16_t Capacity>
+std::size_t BasicHeuristicMapper<Capacity>::evictClosedNodes() {
+  const auto usage = closedNodesMemoryUsage();
+  const auto share = static_cast<double>(results.config.memoryLimit) *
+                     MEMORY_LIMIT_CLOSED_SET_SHARE;
+  if (results.config.memoryLimit == 0 || static_cast<double>(usage) <= share) {
+    return usage;
+  }
+  const auto keep = static_cast<std::size_t>(
+      static_cast<double>(closedNodes.size()) * share *
+      MEMORY_LIMIT_PRUNE_TARGET / static_cast<double>(usage));
+  if (keep == 0) {
+    ClosedSet(&searchArena).swap(closedNodes);
+    return closedNodesMemoryUsage();
+  }
+
+  // entries with a cost above the threshold are evicted, and as many entries
+  // with exactly the threshold cost as needed
+  std::vector<double> costs{};
+  costs.reserve(closedNodes.size());
+  for (const auto& [mapping, cost] : closedNodes) {
+    costs.emplace_back(cost);
+  }
+  std::nth_element(costs.begin(),
+                   costs.begin() + static_cast<std::ptrdiff_t>(keep),
+                   costs.end());
+  const auto threshold = costs[keep];
+  auto       remaining = static_cast<std::size_t>(std::count_if(
+      costs.begin(), costs.end(),
+      [threshold](const double cost) { return cost <= threshold; }));
+  for (auto it = closedNodes.begin(); it != closedNodes.end();) {
+    if (it->second > threshold ||
+        (it->second == threshold && remaining > keep)) {
+      if (it->second == threshold) {
+        --remaining;
+      }
+      it = closedNodes.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // release the buckets of the evicted entries
+  closedNodes.rehash(0);
+  return closedNodesMemoryUsage();
+}
+
+template <std::uint16_t Capacity>
+template <class Open>
+std::size_t
+BasicHeuristicMapper<Capacity>::pruneOpenList(
+    Open& open, const std::size_t memoryLimit,
+    const std::size_t reservedMemory) {
+  const auto usage = open.memoryUsage();
+  if (memoryLimit == 0 || usage + reservedMemory <= memoryLimit) {
+    return 0;
+  }
+  // shrink well below the limit, so that pruning is not triggered again by
+  // the next expansion
+  const auto target = std::max(
+      0., static_cast<double>(memoryLimit) * MEMORY_LIMIT_PRUNE_TARGET -
+              static_cast<double>(reservedMemory));
+  const auto size = open.size();
+  const auto keep = std::max<std::size_t>(
+      1, static_cast<std::size_t>(static_cast<double>(size) * target /
+                                  static_cast<double>(usage)));
+  open.truncate(keep);
+  return size - open.size();
+}
+
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::hdaStarMap(
+    const Node& root, const std::unordered_set<std::uint16_t>& consideredQubits,
+    const LookaheadWindow&                  lookaheadWindow,
+    const TwoQubitMultiplicity&             twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex&        multiplicityIndex,
+    MappingResults::HeuristicBenchmarkInfo& layerResults) {
+  // the teleportation edges are fixed during the search (teleportation is not
+  // supported by HDA*), so that the architecture is only read by the threads
+  updateTeleportationEdges(root);
+
+  const std::size_t nThreads = workerPool == nullptr ? 1 : workerPool->size();
+  const auto        owner    = [nThreads](const Node& n) {
+    // the low bits of the hash are already used by the open lists
+    return static_cast<std::size_t>(n.hash >> 32U) % nThreads;
+  };
+
+  // the memory limit is split evenly between the open lists of all threads
+  const auto memoryLimit = results.config.memoryLimit / nThreads;
+
+  struct SearchThread {
+    OpenList                open{};
+    std::mutex              inboxMutex{};
+    std::condition_variable inboxChanged{};
+    std::vector<Node>       inbox{};
+    std::size_t             expandedNodes = 0;
+    std::size_t             prunedNodes   = 0;
+  };
+  std::vector<SearchThread> threads(nThreads);
+  threads[owner(root)].open.push(root);
+
+  // best goal node found so far
+  std::mutex          incumbentMutex{};
+  std::optional<Node> incumbent{};
+  std::atomic<double> incumbentCost{std::numeric_limits<double>::infinity()};
+
+  // number of active threads plus number of nodes sent but not yet received;
+  // the search is finished as soon as it drops to 0
+  std::atomic<std::size_t> work{nThreads};
+  std::atomic<bool>        finished{false};
+  // set if a thread exceeded `memoryLimitExpansionBound`
+  std::atomic<bool> abandoned{false};
+  const auto               finish = [&]() {
+    finished = true;
+    for (auto& thread : threads) {
+      const std::lock_guard<std::mutex> lock(thread.inboxMutex);
+      thread.inboxChanged.notify_all();
+    }
+  };
+
+  const auto searchThread = [&](const std::size_t id) {
+    auto&                          self = threads[id];
+    std::vector<std::vector<Node>> outboxes(nThreads);
+    std::vector<Node>              received{};
+    // see `memoryLimitExpansionBound` (set once nodes have been pruned)
+    std::optional<std::size_t> maxExpandedNodes{};
+
+    while (!finished) {
+      if (maxExpandedNodes.has_value() &&
+          self.expandedNodes >= *maxExpandedNodes) {
+        abandoned = true;
+        finish();
+        break;
+      }
+      {
+        const std::lock_guard<std::mutex> lock(self.inboxMutex);
+        std::swap(received, self.inbox);
+      }
+      for (const auto& n : received) {
+        self.open.push(n);
+      }
+      work -= received.size();
+      received.clear();
+
+      // nodes not cheaper than the incumbent cannot lead to a better goal
+      if (self.open.empty() ||
+          self.open.top().getTotalCost() >= incumbentCost - 1e-6) {
+        std::unique_lock<std::mutex> lock(self.inboxMutex);
+        if (!self.inbox.empty()) {
+          continue;
+        }
+        if (--work == 0) {
+          lock.unlock();
+          finish();
+          break;
+        }
+        self.inboxChanged.wait(
+            lock, [&]() { return finished || !self.inbox.empty(); });
+        if (finished) {
+          break;
+        }
+        ++work;
+        continue;
+      }
+
+      Node current = self.open.top();
+      self.open.pop();
+      if (current.done) {
+        const std::lock_guard<std::mutex> lock(incumbentMutex);
+        if (!incumbent.has_value() || *incumbent > current) {
+          incumbentCost = current.getTotalCost();
+          incumbent     = std::move(current);
+        }
+        continue;
+      }
+
+      const auto swapChain = current.getSwapChain();
+      const auto swaps     = getCandidateSwaps(consideredQubits, current);
+      const auto scores =
+          scoreCandidateSwaps(current, swaps, multiplicityIndex);
+      for (std::size_t i = 0; i < swaps.size(); ++i) {
+        auto child = createChildNode(swaps[i], scores[i], current, swapChain,
+                                     lookaheadWindow, twoQubitGateMultiplicity);
+        const auto target = owner(child);
+        if (target == id) {
+          self.open.push(child);
+        } else {
+          outboxes[target].emplace_back(std::move(child));
+        }
+      }
+      ++self.expandedNodes;
+      const auto prunedNodes = pruneOpenList(self.open, memoryLimit);
+      self.prunedNodes += prunedNodes;
+      if (prunedNodes > 0 && !maxExpandedNodes.has_value()) {
+        maxExpandedNodes =
+            memoryLimitExpansionBound(self.expandedNodes, self.open.size());
+      }
+
+      for (std::size_t target = 0; target < nThreads; ++target) {
+        auto& outbox = outboxes[target];
+        if (outbox.empty()) {
+          continue;
+        }
+        // count the nodes as work before they become visible to the receiver
+        work += outbox.size();
+        auto&                             receiver = threads[target];
+        const std::lock_guard<std::mutex> lock(receiver.inboxMutex);
+        receiver.inbox.insert(receiver.inbox.end(),
+                              std::make_move_iterator(outbox.begin()),
+                              std::make_move_iterator(outbox.end()));
+        receiver.inboxChanged.notify_one();
+        outbox.clear();
+      }
+    }
+  };
+  const auto search = [&](const std::size_t id) {
+    try {
+      searchThread(id);
+    } catch (...) {
+      // the other threads would otherwise wait for this one forever
+      finish();
+      throw;
+    }
+  };
+
+  if (workerPool == nullptr) {
+    search(0);
+  } else {
+    workerPool->parallelFor(nThreads, search);
+  }
+
+  for (const auto& thread : threads) {
+    layerResults.expandedNodes += thread.expandedNodes;
+    layerResults.prunedNodes += thread.prunedNodes;
+    layerResults.generatedNodes +=
+        thread.expandedNodes + thread.prunedNodes + thread.open.size();
+  }
+  if (abandoned && !incumbent.has_value()) {
+    return idaStarMap(root, consideredQubits, lookaheadWindow,
+                      twoQubitGateMultiplicity, multiplicityIndex,
+                      layerResults);
+  }
+  if (!incumbent.has_value()) {
+    throw QMAPException("HDA* search terminated without finding a mapping.");
+  }
+  return *incumbent;
+}
+
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::updateTeleportationEdges(
+    const Node& node) {
+  const auto firstTeleportationQubit = node.locations.begin() + qc.getNqubits();
+  std::vector<std::int16_t> locs(
+      firstTeleportationQubit,
+      firstTeleportationQubit +
+          static_cast<std::ptrdiff_t>(results.config.teleportationQubits));
+  if (teleportationLocations == locs) {
+    return;
   }
 
   // set up new teleportation qubits
-  std::set<Edge> perms = architecture.getCouplingMap();
-  architecture.getCurrentTeleportations().clear();
+  CouplingMap teleportations{};
   architecture.getTeleportationQubits().clear();
-  for (std::size_t i = 0; i < results.config.teleportationQubits; i += 2) {
-    architecture.getTeleportationQubits().emplace_back(
-        node.locations.at(qc.getNqubits() + i),
-        node.locations.at(qc.getNqubits() + i + 1));
-    Edge e;
-    for (auto const& g : architecture.getCouplingMap()) {
-      if (g.first == node.locations.at(qc.getNqubits() + i) &&
-          g.second != node.locations.at(qc.getNqubits() + i + 1)) {
-        e.first  = g.second;
-        e.second = static_cast<std::uint16_t>(
-            node.locations.at(qc.getNqubits() + i + 1));
-        architecture.getCurrentTeleportations().insert(e);
-        perms.insert(e);
-      }
-      if (g.second == node.locations.at(qc.getNqubits() + i) &&
-          g.first != node.locations.at(qc.getNqubits() + i + 1)) {
-        e.first  = g.first;
-        e.second = static_cast<std::uint16_t>(
-            node.locations.at(qc.getNqubits() + i + 1));
-        architecture.getCurrentTeleportations().insert(e);
-        perms.insert(e);
-      }
-      if (g.first == node.locations.at(qc.getNqubits() + i + 1) &&
-          g.second != node.locations.at(qc.getNqubits() + i)) {
-        e.first = g.second;
-        e.second =
-            static_cast<std::uint16_t>(node.locations.at(qc.getNqubits() + i));
-        architecture.getCurrentTeleportations().insert(e);
-        perms.insert(e);
-      }
-      if (g.second == node.locations.at(qc.getNqubits() + i + 1) &&
-          g.first != node.locations.at(qc.getNqubits() + i)) {
-        e.first = g.first;
-        e.second =
-            static_cast<std::uint16_t>(node.locations.at(qc.getNqubits() + i));
-        architecture.getCurrentTeleportations().insert(e);
-        perms.insert(e);
+  for (std::size_t i = 0; i < locs.size(); i += 2) {
+    const auto first  = static_cast<std::uint16_t>(locs.at(i));
+    const auto second = static_cast<std::uint16_t>(locs.at(i + 1));
+    architecture.getTeleportationQubits().emplace_back(locs.at(i),
+                                                       locs.at(i + 1));
+    for (const auto neighbour : architecture.getNeighbours(first)) {
+      if (neighbour != second) {
+        teleportations.emplace(neighbour, second);
+      }
+    }
+    for (const auto neighbour : architecture.getNeighbours(second)) {
+      if (neighbour != first) {
+        teleportations.emplace(neighbour, first);
       }
     }
   }
+  architecture.setCurrentTeleportations(teleportations);
+
+  teleportationEdges.assign(architecture.getNqubits(), {});
+  for (const auto& edge : teleportations) {
+    // edges already in the coupling map are used for a regular swap instead
+    if (!architecture.isEdgeConnected(edge, false)) {
+      teleportationEdges.at(edge.first).emplace_back(edge);
+      teleportationEdges.at(edge.second).emplace_back(edge);
+    }
+  }
+  teleportationLocations = std::move(locs);
+}
+
+template <std::uint16_t Capacity>
+std::vector<Edge> BasicHeuristicMapper<Capacity>::getCandidateSwaps(
+    const std::unordered_set<std::uint16_t>& consideredQubits,
+    const Node&                              node) const {
+  // physical qubits for which all incident swaps have already been generated
+  std::bitset<Capacity> expandedQubits{};
+  std::vector<Edge>     swaps{};
+
+  // swaps on disjoint edges commute, so of two consecutive swaps on disjoint
+  // edges only the order with ascending edges is considered if requested (both
+  // orders are available, since neither swap moves the qubits of the other
+  // edge and the candidates only depend on the qubits mapped to an edge)
+  std::optional<Edge> lastSwap{};
+  if (results.config.pruneCommutingSwaps && node.lastSwap.has_value() &&
+      node.lastSwap->op == qc::SWAP) {
+    lastSwap = {std::min(node.lastSwap->first, node.lastSwap->second),
+                std::max(node.lastSwap->first, node.lastSwap->second)};
+  }
+  const auto commutesWithLastSwap = [&lastSwap](const Edge& edge) {
+    return lastSwap.has_value() && edge.first != lastSwap->first &&
+           edge.first != lastSwap->second && edge.second != lastSwap->first &&
+           edge.second != lastSwap->second;
+  };
 
   for (const auto& q : consideredQubits) {
-    for (const auto& edge : perms) {
-      if (edge.first == node.locations.at(q) ||
-          edge.second == node.locations.at(q)) {
-        auto q1 = node.qubits.at(edge.first);
-        auto q2 = node.qubits.at(edge.second);
-        if (q2 == -1 || q1 == -1) {
-          expandNodeAddOneSwap(edge, node, layer, twoQubitGateMultiplicity);
-        } else if (!usedSwaps.at(static_cast<std::size_t>(q1))
-                        .at(static_cast<std::size_t>(q2))) {
-          usedSwaps.at(static_cast<std::size_t>(q1))
-              .at(static_cast<std::size_t>(q2)) = true;
-          usedSwaps.at(static_cast<std::size_t>(q2))
-              .at(static_cast<std::size_t>(q1)) = true;
-          expandNodeAddOneSwap(edge, node, layer, twoQubitGateMultiplicity);
-        }
+    const auto loc = static_cast<std::uint16_t>(node.locations.at(q));
+    for (const auto neighbour : architecture.getNeighbours(loc)) {
+      if (expandedQubits.test(neighbour)) {
+        continue;
       }
+      // prefer the edge in ascending order if both directions are available
+      Edge swap{std::min(loc, neighbour), std::max(loc, neighbour)};
+      if (commutesWithLastSwap(swap) && swap < *lastSwap) {
+        continue;
+      }
+      if (!architecture.isEdgeConnected(swap)) {
+        std::swap(swap.first, swap.second);
+      }
+      swaps.emplace_back(swap);
+    }
+    for (const auto& edge : teleportationEdges.at(loc)) {
+      if (expandedQubits.test(edge.first == loc ? edge.second : edge.first)) {
+        continue;
+      }
+      swaps.emplace_back(edge);
     }
+    expandedQubits.set(loc);
   }
+  return swaps;
 }
 
-void HeuristicMapper::expandNodeAddOneSwap(
-    const Edge& swap, Node& node, const std::size_t layer,
-    const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
+template <std::uint16_t Capacity>
+std::vector<typename BasicHeuristicMapper<Capacity>::SwapScore>
+BasicHeuristicMapper<Capacity>::scoreCandidateSwaps(
+    const Node& node, const std::vector<Edge>& swaps,
+    const TwoQubitMultiplicityIndex& multiplicityIndex) const {
+  if (results.config.teleportationQubits > 0) {
+    // distances depend on the teleportation qubits of the expanded node, so
+    // the heuristic cost of the parent cannot be reused
+    return std::vector<SwapScore>(swaps.size());
+  }
+  if (useSwapCountBound()) {
+    // the swap count bound depends on all pairs of the layer
+    return std::vector<SwapScore>(swaps.size());
+  }
+  return node.scoreSwaps(architecture, multiplicityIndex, swaps,
+                         results.config.admissibleHeuristic);
+}
+
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::expandNode(
+    const std::unordered_set<std::uint16_t>& consideredQubits, Node& node,
+    const LookaheadWindow&           lookaheadWindow,
+    const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex& multiplicityIndex) {
+  for (const auto& child :
+       createChildNodes(consideredQubits, node, lookaheadWindow,
+                        twoQubitGateMultiplicity, multiplicityIndex,
+                        &searchArena)) {
+    const auto closed = closedNodes.find({child.hash, child.qubits});
+    if (closed != closedNodes.end() && closed->second <= child.costFixed) {
+      continue;
+    }
+    nodes.push(child);
+  }
+}
+
+template <std::uint16_t Capacity>
+std::vector<typename BasicHeuristicMapper<Capacity>::Node>
+BasicHeuristicMapper<Capacity>::createChildNodes(
+    const std::unordered_set<std::uint16_t>& consideredQubits,
+    const Node& node, const LookaheadWindow& lookaheadWindow,
+    const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex& multiplicityIndex,
+    std::pmr::memory_resource*       resource) {
+  updateTeleportationEdges(node);
+
+  // the swaps of this node are shared with all its children
+  const auto swapChain = node.getSwapChain(resource);
+
+  const auto swaps  = getCandidateSwaps(consideredQubits, node);
+  const auto scores = scoreCandidateSwaps(node, swaps, multiplicityIndex);
+
+  std::vector<Node> children{};
+  if (workerPool == nullptr) {
+    children.reserve(swaps.size());
+    for (std::size_t i = 0; i < swaps.size(); ++i) {
+      children.emplace_back(createChildNode(swaps[i], scores[i], node,
+                                            swapChain, lookaheadWindow,
+                                            twoQubitGateMultiplicity));
+    }
+    return children;
+  }
+
+  // the children are evaluated in any order, but returned in the order of
+  // their swaps, so that the result does not depend on the number of threads
+  children.resize(swaps.size());
+  workerPool->parallelFor(swaps.size(), [&](const std::size_t i) {
+    children[i] =
+        createChildNode(swaps[i], scores[i], node, swapChain, lookaheadWindow,
+                        twoQubitGateMultiplicity);
+  });
+  return children;
+}
+
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::createChildNode(
+    const Edge& swap, const SwapScore& score, const Node& node,
+    const std::shared_ptr<const SwapChain>& swapChain,
+    const LookaheadWindow&                  lookaheadWindow,
+    const TwoQubitMultiplicity&             twoQubitGateMultiplicity) {
   const auto& config = results.config;
 
-  Node newNode = Node(node.qubits, node.locations, node.swaps, node.costFixed,
-                      node.depth + 1);
+  Node newNode = node.createChild(swapChain);
 
-  if (architecture.getCouplingMap().find(swap) !=
-          architecture.getCouplingMap().end() ||
-      architecture.getCouplingMap().find(Edge{swap.second, swap.first}) !=
-          architecture.getCouplingMap().end()) {
+  if (architecture.isEdgeConnected(swap, false)) {
     newNode.applySWAP(swap, architecture);
   } else {
     newNode.applyTeleportation(swap, architecture);
   }
 
-  newNode.updateHeuristicCost(architecture, twoQubitGateMultiplicity,
-                              results.config.admissibleHeuristic);
+  newNode.applySwapScore(score, architecture, twoQubitGateMultiplicity,
+                         config.admissibleHeuristic, useSwapCountBound(),
+                         activePatternDatabase());
 
   // calculate heuristics for the cost of the following layers
   if (config.lookahead) {
-    lookahead(getNextLayer(layer), newNode);
+    lookahead(lookaheadWindow, newNode);
   }
 
-  nodes.push(newNode);
+  return newNode;
 }
 
-void HeuristicMapper::lookahead(const std::size_t      layer,
-                                HeuristicMapper::Node& node) {
-  const auto& config    = results.config;
-  auto        nextLayer = layer;
-  double      factor    = config.firstLookaheadFactor;
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::LookaheadWindow
+BasicHeuristicMapper<Capacity>::createLookaheadWindow(const std::size_t layer) {
+  const auto&     config = results.config;
+  LookaheadWindow window{};
+  // weights of all pairs for the non-admissible heuristic
+  std::map<Edge, double> weights{};
 
+  auto   nextLayer = getNextLayer(layer);
+  double factor    = config.firstLookaheadFactor;
   for (std::size_t i = 0; i < config.nrLookaheads; ++i) {
     if (nextLayer == std::numeric_limits<std::size_t>::max()) {
       break;
     }
 
-    double penalty = 0.;
-    for (const auto& gate : layers.at(nextLayer)) {
-      if (gate.singleQubit()) {
-        continue;
+    std::set<Edge> layerPairs{};
+    for (const auto& gate : layers.twoQubitGates(nextLayer)) {
+      const Edge pair{static_cast<std::uint16_t>(gate.control), gate.target};
+      if (config.admissibleHeuristic) {
+        layerPairs.emplace(pair);
+      } else {
+        weights[pair] += factor;
+      }
+    }
+    if (config.admissibleHeuristic) {
+      auto& group  = window.emplace_back();
+      group.factor = factor;
+      for (const auto& pair : layerPairs) {
+        group.pairs.emplace_back(pair, 1.);
+      }
+    }
+
+    factor *= config.lookaheadFactor;
+    nextLayer = getNextLayer(nextLayer); // TODO: consider single qubits here
+                                         // for better fidelity lookahead
+  }
+
+  if (!config.admissibleHeuristic && !weights.empty()) {
+    window.emplace_back().pairs.assign(weights.begin(), weights.end());
+  }
+  return window;
+}
+
+template <std::uint16_t Capacity>
+std::string BasicHeuristicMapper<Capacity>::layerCacheConfiguration(
+    const Configuration& config) {
+  nlohmann::json settings{};
+  settings["layering_strategy"]     = ::toString(config.layering);
+  settings["admissible_heuristic"]  = config.admissibleHeuristic;
+  settings["consider_fidelity"]     = config.considerFidelity;
+  settings["search_algorithm"]      = ::toString(config.searchAlgorithm);
+  settings["prune_commuting_swaps"] = config.pruneCommutingSwaps;
+  settings["swap_count_bound"]      = config.swapCountBound;
+  settings["use_pattern_database"]  = config.usePatternDatabase;
+  if (config.searchAlgorithm == SearchAlgorithm::AnytimeAStar) {
+    settings["heuristic_weight"]          = config.heuristicWeight;
+    settings["heuristic_weight_decrease"] = config.heuristicWeightDecrease;
+  }
+  if (config.lookahead) {
+    settings["lookaheads"]   = config.nrLookaheads;
+    settings["first_factor"] = config.firstLookaheadFactor;
+    settings["factor"]       = config.lookaheadFactor;
+  }
+  return settings.dump();
+}
+
+template <std::uint16_t Capacity>
+std::optional<LayerCache::Key>
+BasicHeuristicMapper<Capacity>::createLayerCacheKey(
+    const std::size_t           layer,
+    const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
+  const auto&     config = results.config;
+  LayerCache::Key key{};
+
+  // pairs of the layer as (physical qubit 1, physical qubit 2, gates from 1
+  // to 2, gates from 2 to 1), ordered by their physical qubits
+  std::vector<std::array<std::int32_t, 4>> pairs{};
+  for (const auto& [edge, multiplicity] : twoQubitGateMultiplicity) {
+    std::int32_t loc1     = locations.at(edge.first);
+    std::int32_t loc2     = locations.at(edge.second);
+    std::int32_t straight = multiplicity.first;
+    std::int32_t reverse  = multiplicity.second;
+    if (loc1 > loc2) {
+      std::swap(loc1, loc2);
+      std::swap(straight, reverse);
+    }
+    pairs.push_back({loc1, loc2, straight, reverse});
+  }
+  std::sort(pairs.begin(), pairs.end());
+  for (const auto& pair : pairs) {
+    key.insert(key.end(), pair.begin(), pair.end());
+  }
+  key.emplace_back(-1);
+
+  if (!config.lookahead) {
+    return key;
+  }
+
+  // gates of the lookahead layers (as in `createLookaheadWindow`)
+  auto nextLayer = getNextLayer(layer);
+  for (std::size_t i = 0; i < config.nrLookaheads; ++i) {
+    if (nextLayer == std::numeric_limits<std::size_t>::max()) {
+      break;
+    }
+    std::vector<std::pair<std::int32_t, std::int32_t>> gates{};
+    for (const auto& gate : layers.twoQubitGates(nextLayer)) {
+      const auto loc1 =
+          locations.at(static_cast<std::uint16_t>(gate.control));
+      const auto loc2 = locations.at(gate.target);
+      if (loc1 == DEFAULT_POSITION || loc2 == DEFAULT_POSITION) {
+        return std::nullopt;
       }
+      gates.emplace_back(loc1, loc2);
+    }
+    std::sort(gates.begin(), gates.end());
+    for (const auto& [loc1, loc2] : gates) {
+      key.emplace_back(loc1);
+      key.emplace_back(loc2);
+    }
+    key.emplace_back(-1);
+    nextLayer = getNextLayer(nextLayer);
+  }
+  return key;
+}
+
+template <std::uint16_t Capacity>
+typename BasicHeuristicMapper<Capacity>::Node
+BasicHeuristicMapper<Capacity>::replaySwaps(
+    const Node& root, const std::vector<Edge>& swaps,
+    const LookaheadWindow&      lookaheadWindow,
+    const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
+  Node node = root;
+  for (const auto& swap : swaps) {
+    node = node.createChild(node.getSwapChain(&searchArena));
+    node.applySWAP(swap, architecture);
+  }
+  if (swaps.empty()) {
+    return node;
+  }
+  node.updateHeuristicCost(architecture, twoQubitGateMultiplicity,
+                           results.config.admissibleHeuristic,
+                           useSwapCountBound(), activePatternDatabase());
+  if (results.config.lookahead) {
+    lookahead(lookaheadWindow, node);
+  }
+  return node;
+}
 
-      auto loc1 = node.locations.at(static_cast<std::uint16_t>(gate.control));
-      auto loc2 = node.locations.at(gate.target);
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::lookahead(
+    const LookaheadWindow& lookaheadWindow, Node& node) {
+  for (const auto& group : lookaheadWindow) {
+    double penalty = 0.;
+    for (const auto& [pair, weight] : group.pairs) {
+      const auto& [control, target] = pair;
+
+      auto loc1 = node.locations.at(control);
+      auto loc2 = node.locations.at(target);
       if (loc1 == DEFAULT_POSITION && loc2 == DEFAULT_POSITION) {
         // no penalty
       } else if (loc1 == DEFAULT_POSITION) {
@@ -648,46 +1467,71 @@ void HeuristicMapper::lookahead(const std::size_t      layer,
           if (node.qubits.at(j) == DEFAULT_POSITION) {
             // TODO: Consider fidelity here if available
             min = std::min(min, distanceOnArchitectureOfPhysicalQubits(
-                                    j, static_cast<std::uint16_t>(
-                                           node.locations.at(gate.target))));
+                                    j, static_cast<std::uint16_t>(loc2)));
           }
         }
-        penalty = heuristicAddition(penalty, min);
+        penalty = heuristicAddition(penalty, weight * min);
       } else if (loc2 == DEFAULT_POSITION) {
         auto min = std::numeric_limits<double>::max();
         for (std::uint16_t j = 0; j < architecture.getNqubits(); ++j) {
           if (node.qubits.at(j) == DEFAULT_POSITION) {
             // TODO: Consider fidelity here if available
-            min = std::min(min,
-                           distanceOnArchitectureOfPhysicalQubits(
-                               static_cast<std::uint16_t>(node.locations.at(
-                                   static_cast<std::uint16_t>(gate.control))),
-                               j));
+            min = std::min(min, distanceOnArchitectureOfPhysicalQubits(
+                                    static_cast<std::uint16_t>(loc1), j));
           }
         }
-        penalty = heuristicAddition(penalty, min);
+        penalty = heuristicAddition(penalty, weight * min);
       } else {
-        auto cost = architecture.distance(
-            static_cast<std::uint16_t>(
-                node.locations.at(static_cast<std::uint16_t>(gate.control))),
-            static_cast<std::uint16_t>(node.locations.at(gate.target)));
-        penalty = heuristicAddition(penalty, cost);
+        auto cost = architecture.distance(static_cast<std::uint16_t>(loc1),
+                                          static_cast<std::uint16_t>(loc2));
+        penalty   = heuristicAddition(penalty, weight * cost);
       }
     }
 
-    node.lookaheadPenalty += factor * penalty;
-    factor *= config.lookaheadFactor;
-    nextLayer = getNextLayer(nextLayer); // TODO: consider single qubits here
-                                         // for better fidelity lookahead
+    node.lookaheadPenalty += group.factor * penalty;
   }
 }
 
-void HeuristicMapper::Node::applySWAP(const Edge& swap, Architecture& arch) {
+template <std::uint16_t Capacity>
+TwoQubitMultiplicityIndex
+BasicHeuristicMapper<Capacity>::createMultiplicityIndex(
+    const TwoQubitMultiplicity& twoQubitGateMultiplicity) {
+  TwoQubitMultiplicityIndex index{};
+  for (const auto& entry : twoQubitGateMultiplicity) {
+    for (const auto qubit : {entry.first.first, entry.first.second}) {
+      if (qubit >= index.size()) {
+        index.resize(qubit + 1U);
+      }
+      index[qubit].emplace_back(&entry);
+    }
+  }
+  return index;
+}
+
+template <std::uint16_t Capacity>
+std::vector<Exchange> BasicHeuristicMapper<Capacity>::Node::getSwaps() const {
+  std::vector<Exchange> result{};
+  if (lastSwap.has_value()) {
+    result.emplace_back(*lastSwap);
+  }
+  for (const auto* record = previousSwaps.get(); record != nullptr;
+       record             = record->previous.get()) {
+    result.emplace_back(record->swap);
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::applySWAP(const Edge&   swap,
+                                                     Architecture& arch) {
   ++nswaps;
-  swaps.emplace_back();
   const auto q1 = qubits.at(swap.first);
   const auto q2 = qubits.at(swap.second);
 
+  hash ^= zobristKey(swap.first, q1) ^ zobristKey(swap.second, q2) ^
+          zobristKey(swap.first, q2) ^ zobristKey(swap.second, q1);
+
   qubits.at(swap.first)  = q2;
   qubits.at(swap.second) = q1;
 
@@ -700,10 +1544,8 @@ void HeuristicMapper::Node::applySWAP(const Edge& swap, Architecture& arch) {
         static_cast<std::int16_t>(swap.first);
   }
 
-  if (arch.getCouplingMap().find(swap) != arch.getCouplingMap().end() ||
-      arch.getCouplingMap().find(Edge{swap.second, swap.first}) !=
-          arch.getCouplingMap().end()) {
-    swaps.back().emplace_back(swap.first, swap.second, qc::SWAP);
+  if (arch.isEdgeConnected(swap, false)) {
+    addSwap(Exchange(swap.first, swap.second, qc::SWAP));
   } else {
     throw QMAPException("Something wrong in applySWAP.");
   }
@@ -715,13 +1557,16 @@ void HeuristicMapper::Node::applySWAP(const Edge& swap, Architecture& arch) {
   }
 }
 
-void HeuristicMapper::Node::applyTeleportation(const Edge&   swap,
-                                               Architecture& arch) {
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::applyTeleportation(
+    const Edge& swap, Architecture& arch) {
   nswaps++;
-  swaps.emplace_back();
   const auto q1 = qubits.at(swap.first);
   const auto q2 = qubits.at(swap.second);
 
+  hash ^= zobristKey(swap.first, q1) ^ zobristKey(swap.second, q2) ^
+          zobristKey(swap.first, q2) ^ zobristKey(swap.second, q1);
+
   qubits.at(swap.first)  = q2;
   qubits.at(swap.second) = q1;
 
@@ -751,10 +1596,7 @@ void HeuristicMapper::Node::applyTeleportation(const Edge&   swap,
 
   std::uint16_t source = std::numeric_limits<decltype(source)>::max();
   std::uint16_t target = std::numeric_limits<decltype(target)>::max();
-  if (arch.getCouplingMap().find({swap.first, middleAnc}) !=
-          arch.getCouplingMap().end() ||
-      arch.getCouplingMap().find({middleAnc, swap.first}) !=
-          arch.getCouplingMap().end()) {
+  if (arch.isEdgeConnected({swap.first, middleAnc}, false)) {
     source = swap.first;
     target = swap.second;
   } else {
@@ -769,72 +1611,313 @@ void HeuristicMapper::Node::applyTeleportation(const Edge&   swap,
                         "ancillary in teleportation.");
   }
 
-  swaps.back().emplace_back(source, target, middleAnc, qc::Teleportation);
+  addSwap(Exchange(source, target, middleAnc, qc::Teleportation));
 
   costFixed += COST_TELEPORTATION;
 }
 
-void HeuristicMapper::Node::recalculateFixedCost(const Architecture& arch) {
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::recalculateFixedCost(
+    const Architecture& arch) {
   costFixed = 0;
-  for (auto& swapNode : swaps) {
-    for (auto& swap : swapNode) {
-      if (swap.op == qc::SWAP) {
-        if (arch.bidirectional()) {
-          costFixed += COST_BIDIRECTIONAL_SWAP;
-        } else {
-          costFixed += COST_UNIDIRECTIONAL_SWAP;
-        }
-      } else if (swap.op == qc::Teleportation) {
-        costFixed += COST_TELEPORTATION;
+  for (const auto& swap : getSwaps()) {
+    if (swap.op == qc::SWAP) {
+      if (arch.bidirectional()) {
+        costFixed += COST_BIDIRECTIONAL_SWAP;
+      } else {
+        costFixed += COST_UNIDIRECTIONAL_SWAP;
       }
+    } else if (swap.op == qc::Teleportation) {
+      costFixed += COST_TELEPORTATION;
     }
   }
 }
 
-void HeuristicMapper::Node::updateHeuristicCost(
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::updateHeuristicCost(
     const Architecture&         arch,
     const TwoQubitMultiplicity& twoQubitGateMultiplicity,
-    const bool                  admissibleHeuristic) {
-  costHeur = 0.;
-  done     = true;
+    const bool admissibleHeuristic, const bool swapCountBound,
+    const PatternDatabase* patternDatabase) {
+  costHeur         = 0.;
+  nonAdjacentPairs = 0;
 
   // iterating over all virtual qubit pairs, that share a gate on the
   // current layer
   for (const auto& [edge, multiplicity] : twoQubitGateMultiplicity) {
     const auto& [q1, q2] = edge;
-
-    const auto& [straightMultiplicity, reverseMultiplicity] = multiplicity;
+    const auto loc1      = static_cast<std::uint16_t>(locations.at(q1));
+    const auto loc2      = static_cast<std::uint16_t>(locations.at(q2));
 
     // only if all qubit pairs are mapped next to each other the mapping
     // is complete
-    if (arch.getCouplingMap().find(
-            {static_cast<std::uint16_t>(locations.at(q1)),
-             static_cast<std::uint16_t>(locations.at(q2))}) ==
-            arch.getCouplingMap().end() &&
-        arch.getCouplingMap().find(
-            {static_cast<std::uint16_t>(locations.at(q2)),
-             static_cast<std::uint16_t>(locations.at(q1))}) ==
-            arch.getCouplingMap().end()) {
-      done = false;
-    }
-
-    const double swapCostStraight =
-        arch.distance(static_cast<std::uint16_t>(locations.at(q1)),
-                      static_cast<std::uint16_t>(locations.at(q2)));
-    const double swapCostReverse =
-        arch.distance(static_cast<std::uint16_t>(locations.at(q2)),
-                      static_cast<std::uint16_t>(locations.at(q1)));
+    if (!arch.isEdgeConnected({loc1, loc2}, false)) {
+      ++nonAdjacentPairs;
+    }
 
+    const auto pairCost =
+        pairHeuristicCost(arch, loc1, loc2, multiplicity, admissibleHeuristic);
     if (admissibleHeuristic) {
-      if (straightMultiplicity > 0) {
-        costHeur = std::max(costHeur, swapCostStraight);
+      costHeur = std::max(costHeur, pairCost);
+    } else {
+      costHeur += pairCost;
+    }
+  }
+  done = nonAdjacentPairs == 0;
+
+  if (admissibleHeuristic && swapCountBound && !done &&
+      arch.getCurrentTeleportations().empty()) {
+    const auto swaps =
+        swapCountLowerBound(arch, twoQubitGateMultiplicity, patternDatabase);
+    const double swapCost = arch.bidirectional() ? COST_BIDIRECTIONAL_SWAP
+                                                 : COST_UNIDIRECTIONAL_SWAP;
+    costHeur = std::max(costHeur, static_cast<double>(swaps) * swapCost);
+  }
+}
+
+template <std::uint16_t Capacity>
+std::size_t BasicHeuristicMapper<Capacity>::Node::swapCountLowerBound(
+    const Architecture&         arch,
+    const TwoQubitMultiplicity& twoQubitGateMultiplicity,
+    const PatternDatabase*      patternDatabase) const {
+  // every swap on a path costs at most this much
+  const double maxSwapCost = arch.bidirectional() ? COST_BIDIRECTIONAL_SWAP
+                                                  : COST_UNIDIRECTIONAL_SWAP;
+
+  const auto pairSwaps = [&](const std::uint16_t loc1,
+                             const std::uint16_t loc2) -> std::size_t {
+    if (patternDatabase != nullptr) {
+      return patternDatabase->pairSwaps(loc1, loc2);
+    }
+    const auto distance =
+        std::min(arch.distance(loc1, loc2), arch.distance(loc2, loc1));
+    if (distance <= 0.) {
+      return 0U;
+    }
+    return static_cast<std::size_t>(std::floor(distance / maxSwapCost));
+  };
+  const bool groupPairs =
+      patternDatabase != nullptr && patternDatabase->hasTwoPairTable();
+
+  std::bitset<Capacity> matched{};
+  std::size_t           maxSwaps     = 0;
+  std::size_t           matchedSwaps = 0;
+  std::size_t           groupedSwaps = 0;
+  // matched pair waiting for a second pair to form a group with
+  std::optional<std::pair<std::uint16_t, std::uint16_t>> ungrouped{};
+  for (const auto& [edge, multiplicity] : twoQubitGateMultiplicity) {
+    const auto& [q1, q2] = edge;
+    const auto loc1      = static_cast<std::uint16_t>(locations.at(q1));
+    const auto loc2      = static_cast<std::uint16_t>(locations.at(q2));
+    const auto swaps     = pairSwaps(loc1, loc2);
+    maxSwaps             = std::max(maxSwaps, swaps);
+    if (matched.test(q1) || matched.test(q2)) {
+      continue;
+    }
+    matched.set(q1);
+    matched.set(q2);
+    matchedSwaps += swaps;
+
+    if (!groupPairs) {
+      continue;
+    }
+    if (!ungrouped.has_value()) {
+      ungrouped = {loc1, loc2};
+      continue;
+    }
+    const auto groupSwaps = patternDatabase->twoPairSwaps(
+        ungrouped->first, ungrouped->second, loc1, loc2);
+    maxSwaps = std::max(maxSwaps, groupSwaps);
+    groupedSwaps += groupSwaps;
+    ungrouped.reset();
+  }
+  if (ungrouped.has_value()) {
+    groupedSwaps += pairSwaps(ungrouped->first, ungrouped->second);
+  }
+  return std::max({maxSwaps, (matchedSwaps + 1) / 2, (groupedSwaps + 1) / 2});
+}
+
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::updateHeuristicCostAfterSwap(
+    const Architecture&              arch,
+    const TwoQubitMultiplicity&      twoQubitGateMultiplicity,
+    const TwoQubitMultiplicityIndex& multiplicityIndex, const Node& parent,
+    const Edge& swap, const bool admissibleHeuristic) {
+  const auto scores =
+      parent.scoreSwaps(arch, multiplicityIndex, {swap}, admissibleHeuristic);
+  applySwapScore(scores.front(), arch, twoQubitGateMultiplicity,
+                 admissibleHeuristic);
+}
+
+template <std::uint16_t Capacity>
+std::vector<typename BasicHeuristicMapper<Capacity>::SwapScore>
+BasicHeuristicMapper<Capacity>::Node::scoreSwaps(
+    const Architecture&              arch,
+    const TwoQubitMultiplicityIndex& multiplicityIndex,
+    const std::vector<Edge>& swaps, const bool admissibleHeuristic) const {
+  // reused by all expansions of the same thread to avoid reallocations
+  thread_local SwapScoreBatch batch{};
+  batch.clear();
+
+  std::vector<SwapScore> scores(swaps.size());
+  // end of the entries of each swap in `batch`
+  std::vector<std::size_t> entriesEnd(swaps.size());
+  for (std::size_t i = 0; i < swaps.size(); ++i) {
+    const auto& swap = swaps[i];
+    // logical qubits exchanged by the swap, i.e. the only ones whose location
+    // differs from this node
+    const auto movedToFirst  = qubits.at(swap.second);
+    const auto movedToSecond = qubits.at(swap.first);
+    const auto newLocation   = [&](const std::uint16_t q) {
+      if (static_cast<std::int16_t>(q) == movedToFirst) {
+        return swap.first;
       }
-      if (reverseMultiplicity > 0) {
-        costHeur = std::max(costHeur, swapCostReverse);
+      if (static_cast<std::int16_t>(q) == movedToSecond) {
+        return swap.second;
       }
-    } else {
-      costHeur += swapCostStraight * straightMultiplicity +
-                  swapCostReverse * reverseMultiplicity;
+      return static_cast<std::uint16_t>(locations.at(q));
+    };
+
+    auto& score            = scores[i];
+    score.nonAdjacentPairs = nonAdjacentPairs;
+    for (const auto second : {false, true}) {
+      const auto moved = second ? movedToSecond : movedToFirst;
+      if (moved == DEFAULT_POSITION || (second && moved == movedToFirst) ||
+          static_cast<std::size_t>(moved) >= multiplicityIndex.size()) {
+        continue;
+      }
+      for (const auto* entry :
+           multiplicityIndex[static_cast<std::size_t>(moved)]) {
+        const auto& [edge, multiplicity] = *entry;
+        const auto& [q1, q2]             = edge;
+        // pairs of both exchanged qubits are only evaluated once
+        if (second && (q1 == movedToFirst || q2 == movedToFirst)) {
+          continue;
+        }
+
+        const auto oldLoc1 = static_cast<std::uint16_t>(locations.at(q1));
+        const auto oldLoc2 = static_cast<std::uint16_t>(locations.at(q2));
+        const auto newLoc1 = newLocation(q1);
+        const auto newLoc2 = newLocation(q2);
+
+        if (!arch.isEdgeConnected({oldLoc1, oldLoc2}, false)) {
+          --score.nonAdjacentPairs;
+        }
+        if (!arch.isEdgeConnected({newLoc1, newLoc2}, false)) {
+          ++score.nonAdjacentPairs;
+        }
+        batch.add(arch.getNqubits(), oldLoc1, oldLoc2, newLoc1, newLoc2,
+                  multiplicity);
+      }
+    }
+    entriesEnd[i] = batch.size();
+  }
+  if (batch.size() > 0) {
+    batch.evaluate(arch.getDistanceRow(0), admissibleHeuristic);
+  }
+
+  std::size_t entry = 0;
+  for (std::size_t i = 0; i < swaps.size(); ++i) {
+    auto& score    = scores[i];
+    score.costHeur = costHeur;
+    score.valid    = true;
+
+    bool   maximumDecreased = false;
+    double newMaximum       = 0.;
+    for (; entry < entriesEnd[i]; ++entry) {
+      const auto oldCost = batch.oldCost(entry);
+      const auto newCost = batch.newCost(entry);
+      if (admissibleHeuristic) {
+        if (oldCost >= costHeur && newCost < oldCost) {
+          maximumDecreased = true;
+        }
+        newMaximum = std::max(newMaximum, newCost);
+      } else {
+        score.costHeur += newCost - oldCost;
+      }
+    }
+
+    if (admissibleHeuristic) {
+      // if the pair determining the maximum got cheaper, the new maximum
+      // might be attained by any other pair
+      score.valid    = !maximumDecreased;
+      score.costHeur = std::max(costHeur, newMaximum);
     }
   }
+  return scores;
+}
+
+template <std::uint16_t Capacity>
+void BasicHeuristicMapper<Capacity>::Node::applySwapScore(
+    const SwapScore& score, const Architecture& arch,
+    const TwoQubitMultiplicity& twoQubitGateMultiplicity,
+    const bool admissibleHeuristic, const bool swapCountBound,
+    const PatternDatabase* patternDatabase) {
+  if (!score.valid) {
+    updateHeuristicCost(arch, twoQubitGateMultiplicity, admissibleHeuristic,
+                        swapCountBound, patternDatabase);
+    return;
+  }
+  costHeur         = score.costHeur;
+  nonAdjacentPairs = score.nonAdjacentPairs;
+  done             = nonAdjacentPairs == 0;
+}
+
+template class BasicHeuristicMapper<16>;
+template class BasicHeuristicMapper<32>;
+template class BasicHeuristicMapper<64>;
+template class BasicHeuristicMapper<128>;
+template class BasicHeuristicMapper<256>;
+template class BasicHeuristicMapper<MAX_DEVICE_QUBITS>;
+
+void HeuristicMapper::map(const Configuration& configuration) {
+  switch (nodeCapacity(architecture.getNqubits())) {
+  case 16:
+    mapWithCapacity<16>(configuration);
+    break;
+  case 32:
+    mapWithCapacity<32>(configuration);
+    break;
+  case 64:
+    mapWithCapacity<64>(configuration);
+    break;
+  case 128:
+    mapWithCapacity<128>(configuration);
+    break;
+  case 256:
+    mapWithCapacity<256>(configuration);
+    break;
+  case MAX_DEVICE_QUBITS:
+    mapWithCapacity<MAX_DEVICE_QUBITS>(configuration);
+    break;
+  default:
+    results        = MappingResults{};
+    results.config = configuration;
+    std::cerr << "Architectures with more than " << MAX_DEVICE_QUBITS
+              << " qubits are not supported by the heuristic mapper!"
+              << std::endl;
+  }
+}
+
+template <std::uint16_t Capacity>
+void HeuristicMapper::mapWithCapacity(const Configuration& configuration) {
+  if (capacityMapper == nullptr || mapperCapacity != Capacity) {
+    // `qc` has already been preprocessed by the constructor of this mapper
+    capacityMapper.reset(new BasicHeuristicMapper<Capacity>(
+        qc, architecture, PreprocessedCircuit{}));
+    mapperCapacity = Capacity;
+  }
+  auto& mapper = static_cast<BasicHeuristicMapper<Capacity>&>(*capacityMapper);
+  mapper.layerCache = layerCache;
+  mapper.map(configuration);
+  layerCache = mapper.layerCache;
+
+  results           = mapper.results;
+  qcMapped          = std::move(mapper.qcMapped);
+  layers            = std::move(mapper.layers);
+  nextTwoQubitLayer = std::move(mapper.nextTwoQubitLayer);
+  // the layers are created anew by the next mapping run
+  mapper.layers.clear();
+  qubits            = mapper.qubits;
+  locations         = mapper.locations;
 }
@@ -0,0 +1,246 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/PatternDatabase.hpp"
+
+#include "Mapper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+constexpr std::array<char, 8> MAGIC = {'Q', 'M', 'A', 'P', 'P', 'D', 'B', '1'};
+
+template <class T> void writeValue(std::ofstream& ofs, const T& value) {
+  ofs.write(reinterpret_cast<const char*>(&value), // NOLINT
+            sizeof(T));
+}
+
+template <class T> T readValue(std::ifstream& ifs) {
+  T value{};
+  ifs.read(reinterpret_cast<char*>(&value), sizeof(T)); // NOLINT
+  return value;
+}
+} // namespace
+
+PatternDatabase::PatternDatabase(const Architecture& arch)
+    : nqubits(arch.getNqubits()), hash(couplingMapHash(arch)) {
+  // swaps may be applied to any edge in both directions
+  std::vector<std::vector<std::uint16_t>> neighbors(nqubits);
+  for (const auto& [q1, q2] : arch.getCouplingMap()) {
+    neighbors.at(q1).emplace_back(q2);
+    neighbors.at(q2).emplace_back(q1);
+  }
+  for (auto& qubitNeighbors : neighbors) {
+    std::sort(qubitNeighbors.begin(), qubitNeighbors.end());
+    qubitNeighbors.erase(
+        std::unique(qubitNeighbors.begin(), qubitNeighbors.end()),
+        qubitNeighbors.end());
+  }
+
+  buildPairTable(neighbors);
+  if (nqubits <= MAX_TWO_PAIR_QUBITS) {
+    buildTwoPairTable(neighbors);
+  }
+}
+
+std::uint64_t PatternDatabase::couplingMapHash(const Architecture& arch) {
+  // FNV-1a over the bytes of the number of qubits and the (ordered) edges
+  constexpr std::uint64_t PRIME = 1099511628211ULL;
+
+  std::uint64_t result  = 14695981039346656037ULL;
+  const auto    combine = [&result](const std::uint16_t value) {
+    result = (result ^ (value & 0xFFU)) * PRIME;
+    result = (result ^ (value >> 8U)) * PRIME;
+  };
+  combine(arch.getNqubits());
+  for (const auto& [q1, q2] : arch.getCouplingMap()) {
+    combine(q1);
+    combine(q2);
+  }
+  return result;
+}
+
+void PatternDatabase::buildPairTable(
+    const std::vector<std::vector<std::uint16_t>>& neighbors) {
+  pairTable.assign(static_cast<std::size_t>(nqubits) * nqubits, UNREACHABLE);
+
+  // a pair at a distance of n edges needs n - 1 swaps
+  constexpr auto UNVISITED = std::numeric_limits<std::size_t>::max();
+
+  std::vector<std::uint16_t> queue{};
+  std::vector<std::size_t>   hops(nqubits);
+  for (std::uint16_t source = 0; source < nqubits; ++source) {
+    std::fill(hops.begin(), hops.end(), UNVISITED);
+    hops[source] = 0;
+    queue.assign(1, source);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      const auto current = queue[i];
+      for (const auto neighbor : neighbors[current]) {
+        if (hops[neighbor] == UNVISITED) {
+          hops[neighbor] = hops[current] + 1;
+          queue.emplace_back(neighbor);
+        }
+      }
+    }
+    for (std::uint16_t target = 0; target < nqubits; ++target) {
+      if (hops[target] != UNVISITED) {
+        pairTable[static_cast<std::size_t>(source) * nqubits + target] =
+            static_cast<Entry>(std::min<std::size_t>(
+                hops[target] == 0 ? 0 : hops[target] - 1, UNREACHABLE - 1));
+      }
+    }
+  }
+}
+
+void PatternDatabase::buildTwoPairTable(
+    const std::vector<std::vector<std::uint16_t>>& neighbors) {
+  const std::size_t n = nqubits;
+  twoPairTable.assign(n * n * n * n, UNREACHABLE);
+
+  // the search starts from all placements in which both pairs are adjacent
+  // and proceeds backwards (swaps are their own inverse)
+  std::vector<std::uint32_t> queue{};
+  for (std::uint16_t loc1 = 0; loc1 < n; ++loc1) {
+    for (const auto loc2 : neighbors[loc1]) {
+      for (std::uint16_t loc3 = 0; loc3 < n; ++loc3) {
+        if (loc3 == loc1 || loc3 == loc2) {
+          continue;
+        }
+        for (const auto loc4 : neighbors[loc3]) {
+          if (loc4 == loc1 || loc4 == loc2) {
+            continue;
+          }
+          const auto index    = twoPairIndex(loc1, loc2, loc3, loc4);
+          twoPairTable[index] = 0;
+          queue.emplace_back(static_cast<std::uint32_t>(index));
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const auto index = queue[i];
+    const auto next  = static_cast<Entry>(
+        std::min<std::size_t>(twoPairTable[index] + 1U, UNREACHABLE - 1));
+    const std::array<std::uint16_t, 4> placement = {
+        static_cast<std::uint16_t>(index / (n * n * n)),
+        static_cast<std::uint16_t>(index / (n * n) % n),
+        static_cast<std::uint16_t>(index / n % n),
+        static_cast<std::uint16_t>(index % n)};
+
+    // swap the physical qubit of each qubit of the group with each neighbor
+    // (moving another qubit of the group if it is placed there)
+    for (std::size_t moved = 0; moved < placement.size(); ++moved) {
+      for (const auto neighbor : neighbors[placement[moved]]) {
+        auto swapped = placement;
+        for (auto& loc : swapped) {
+          if (loc == neighbor) {
+            loc = placement[moved];
+          }
+        }
+        swapped[moved] = neighbor;
+
+        const auto swappedIndex =
+            twoPairIndex(swapped[0], swapped[1], swapped[2], swapped[3]);
+        if (twoPairTable[swappedIndex] == UNREACHABLE) {
+          twoPairTable[swappedIndex] = next;
+          queue.emplace_back(static_cast<std::uint32_t>(swappedIndex));
+        }
+      }
+    }
+  }
+}
+
+void PatternDatabase::save(const std::string& filename) const {
+  auto ofs = std::ofstream(filename, std::ios::binary);
+  if (!ofs.good()) {
+    throw QMAPException("Error opening pattern database file.");
+  }
+  ofs.write(MAGIC.data(), MAGIC.size());
+  writeValue(ofs, nqubits);
+  writeValue(ofs, hash);
+  writeValue(ofs, static_cast<std::uint8_t>(hasTwoPairTable()));
+  ofs.write(reinterpret_cast<const char*>(pairTable.data()), // NOLINT
+            static_cast<std::streamsize>(pairTable.size()));
+  ofs.write(reinterpret_cast<const char*>(twoPairTable.data()), // NOLINT
+            static_cast<std::streamsize>(twoPairTable.size()));
+  if (!ofs.good()) {
+    throw QMAPException("Error writing pattern database file.");
+  }
+}
+
+PatternDatabase PatternDatabase::load(const std::string& filename) {
+  auto ifs = std::ifstream(filename, std::ios::binary);
+  if (!ifs.good()) {
+    throw QMAPException("Error opening pattern database file.");
+  }
+  std::array<char, MAGIC.size()> magic{};
+  ifs.read(magic.data(), magic.size());
+  if (!ifs.good() || magic != MAGIC) {
+    throw QMAPException("Not a pattern database file: " + filename);
+  }
+
+  PatternDatabase database{};
+  database.nqubits    = readValue<std::uint16_t>(ifs);
+  database.hash       = readValue<std::uint64_t>(ifs);
+  const bool twoPairs = readValue<std::uint8_t>(ifs) != 0U;
+  // check the size before allocating the tables
+  if (!ifs.good() || database.nqubits > MAX_DEVICE_QUBITS ||
+      (twoPairs && database.nqubits > MAX_TWO_PAIR_QUBITS)) {
+    throw QMAPException("Invalid pattern database file: " + filename);
+  }
+
+  const std::size_t n = database.nqubits;
+  database.pairTable.resize(n * n);
+  ifs.read(reinterpret_cast<char*>(database.pairTable.data()), // NOLINT
+           static_cast<std::streamsize>(database.pairTable.size()));
+  if (twoPairs) {
+    database.twoPairTable.resize(n * n * n * n);
+    ifs.read(reinterpret_cast<char*>(database.twoPairTable.data()), // NOLINT
+             static_cast<std::streamsize>(database.twoPairTable.size()));
+  }
+  if (!ifs.good()) {
+    throw QMAPException("Error reading pattern database file.");
+  }
+  return database;
+}
+
+std::string PatternDatabase::filename(const Architecture& arch) {
+  std::ostringstream name{};
+  name << std::hex << std::setw(16) << std::setfill('0')
+       << couplingMapHash(arch) << ".pdb";
+  return name.str();
+}
+
+std::shared_ptr<const PatternDatabase>
+PatternDatabase::loadOrCreate(const Architecture& arch,
+                              const std::string&  directory) {
+  if (directory.empty()) {
+    return std::make_shared<const PatternDatabase>(arch);
+  }
+
+  const auto path = std::filesystem::path(directory) / filename(arch);
+  if (std::filesystem::exists(path)) {
+    // the file is rebuilt if it cannot be read (e.g. since it is truncated or
+    // was written by another version) or if its contents do not match its name
+    try {
+      auto database = load(path.string());
+      if (database.matches(arch)) {
+        return std::make_shared<const PatternDatabase>(std::move(database));
+      }
+    } catch (const QMAPException&) {
+    }
+  }
+
+  auto database = std::make_shared<const PatternDatabase>(arch);
+  std::filesystem::create_directories(directory);
+  database->save(path.string());
+  return database;
+}
@@ -32,6 +32,7 @@ from .pyqmap import (
     MappingResults,
     Method,
     QuantumComputation,
+    SearchAlgorithm,
     SwapReduction,
     SynthesisConfiguration,
     SynthesisResults,
@@ -46,6 +47,7 @@ __all__ = [
     "Method",
     "InitialLayout",
     "Layering",
+    "SearchAlgorithm",
     "Arch",
     "CommanderGrouping",
     "SwapReduction",
@@ -109,21 +109,31 @@ class CommanderGrouping:
 class Configuration:
     add_measurements_to_mapped_circuit: bool
     admissible_heuristic: bool
+    cache_layer_solutions: bool
     consider_fidelity: bool
     commander_grouping: CommanderGrouping
     enable_limits: bool
     encoding: Encoding
     first_lookahead_factor: float
+    heuristic_weight: float
+    heuristic_weight_decrease: float
     include_WCNF: bool  # noqa: N815
     initial_layout: InitialLayout
+    layer_timeout: int
     layering: Layering
     lookahead: bool
     lookahead_factor: float
     lookaheads: int
+    memory_limit: int
     method: Method
+    n_threads: int
+    pattern_database_directory: str
     post_mapping_optimizations: bool
     pre_mapping_optimizations: bool
+    prune_commuting_swaps: bool
+    search_algorithm: SearchAlgorithm
     subgraph: set[int]
+    swap_count_bound: bool
     swap_limit: int
     swap_reduction: SwapReduction
     teleportation_fake: bool
@@ -131,6 +141,7 @@ class Configuration:
     teleportation_seed: int
     timeout: int
     use_bdd: bool
+    use_pattern_database: bool
     use_subsets: bool
     use_teleportation: bool
     verbose: bool
@@ -184,6 +195,31 @@ class InitialLayout:
     @property
     def value(self) -> int: ...
 
+class SearchAlgorithm:
+    __members__: ClassVar[dict[SearchAlgorithm, int]] = ...  # read-only
+    a_star: ClassVar[SearchAlgorithm] = ...
+    hda_star: ClassVar[SearchAlgorithm] = ...
+    ida_star: ClassVar[SearchAlgorithm] = ...
+    anytime_a_star: ClassVar[SearchAlgorithm] = ...
+    pea_star: ClassVar[SearchAlgorithm] = ...
+    @overload
+    def __init__(self, value: int) -> None: ...
+    @overload
+    def __init__(self, arg0: str) -> None: ...
+    @overload
+    def __init__(self, arg0: SearchAlgorithm) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    def __setstate__(self, state: int) -> None: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
 class Layering:
     __members__: ClassVar[dict[Layering, int]] = ...  # read-only
     disjoint_qubits: ClassVar[Layering] = ...
@@ -214,6 +250,7 @@ class MappingResults:
     input: Any  # noqa: A003
     mapped_circuit: str
     output: Any
+    suboptimality_bound: float | None  # only for the admissible anytime search without lookahead
     time: float
     timeout: bool
     wcnf: str
@@ -123,6 +123,19 @@ PYBIND11_MODULE(pyqmap, m) {
         return initialLayoutFromString(str);
       }));
 
+  // Search algorithm of the heuristic mapper
+  py::enum_<SearchAlgorithm>(m, "SearchAlgorithm")
+      .value("a_star", SearchAlgorithm::AStar)
+      .value("hda_star", SearchAlgorithm::HDAStar)
+      .value("ida_star", SearchAlgorithm::IDAStar)
+      .value("anytime_a_star", SearchAlgorithm::AnytimeAStar)
+      .value("pea_star", SearchAlgorithm::PEAStar)
+      .export_values()
+      // allow construction from string
+      .def(py::init([](const std::string& str) -> SearchAlgorithm {
+        return searchAlgorithmFromString(str);
+      }));
+
   // Gate clustering / layering strategy
   py::enum_<Layering>(m, "Layering")
       .value("individual_gates", Layering::IndividualGates)
@@ -190,6 +203,22 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite("first_lookahead_factor",
                      &Configuration::firstLookaheadFactor)
       .def_readwrite("lookahead_factor", &Configuration::lookaheadFactor)
+      .def_readwrite("search_algorithm", &Configuration::searchAlgorithm)
+      .def_readwrite("n_threads", &Configuration::nThreads)
+      .def_readwrite("memory_limit", &Configuration::memoryLimit)
+      .def_readwrite("prune_commuting_swaps",
+                     &Configuration::pruneCommutingSwaps)
+      .def_readwrite("swap_count_bound", &Configuration::swapCountBound)
+      .def_readwrite("use_pattern_database",
+                     &Configuration::usePatternDatabase)
+      .def_readwrite("pattern_database_directory",
+                     &Configuration::patternDatabaseDirectory)
+      .def_readwrite("cache_layer_solutions",
+                     &Configuration::cacheLayerSolutions)
+      .def_readwrite("heuristic_weight", &Configuration::heuristicWeight)
+      .def_readwrite("heuristic_weight_decrease",
+                     &Configuration::heuristicWeightDecrease)
+      .def_readwrite("layer_timeout", &Configuration::layerTimeout)
       .def_readwrite("use_teleportation", &Configuration::useTeleportation)
       .def_readwrite("teleportation_qubits",
                      &Configuration::teleportationQubits)
@@ -224,6 +253,8 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite("configuration", &MappingResults::config)
       .def_readwrite("time", &MappingResults::time)
       .def_readwrite("timeout", &MappingResults::timeout)
+      .def_readwrite("suboptimality_bound",
+                     &MappingResults::suboptimalityBound)
       .def_readwrite("mapped_circuit", &MappingResults::mappedCircuit)
       .def_readwrite("heuristic_benchmark", &MappingResults::heuristicBenchmark)
       .def_readwrite("layer_heuristic_benchmark",
@@ -258,6 +289,14 @@ PYBIND11_MODULE(pyqmap, m) {
                      &MappingResults::HeuristicBenchmarkInfo::expandedNodes)
       .def_readwrite("generated_nodes",
                      &MappingResults::HeuristicBenchmarkInfo::generatedNodes)
+      .def_readwrite("pruned_nodes",
+                     &MappingResults::HeuristicBenchmarkInfo::prunedNodes)
+      .def_readwrite("reexpanded_nodes",
+                     &MappingResults::HeuristicBenchmarkInfo::reExpandedNodes)
+      .def_readwrite("layer_cache_hits",
+                     &MappingResults::HeuristicBenchmarkInfo::layerCacheHits)
+      .def_readwrite("layer_cache_misses",
+                     &MappingResults::HeuristicBenchmarkInfo::layerCacheMisses)
       .def_readwrite("solution_depth",
                      &MappingResults::HeuristicBenchmarkInfo::solutionDepth)
       .def_readwrite("time_per_node",
@@ -162,6 +162,79 @@ TEST(TestArchitecture, TestCouplingLimitRing) {
   EXPECT_EQ(architecture.getCouplingLimit(), 2);
 }
 
+TEST(TestArchitecture, CouplingLookups) {
+  Architecture      architecture{};
+  const CouplingMap cm = {{0, 1}, {1, 0}, {1, 2}, {3, 1}, {69, 70}};
+  architecture.loadCouplingMap(71, cm);
+
+  EXPECT_TRUE(architecture.isEdgeConnected({0, 1}));
+  EXPECT_TRUE(architecture.isEdgeConnected({1, 0}));
+  EXPECT_TRUE(architecture.isEdgeConnected({1, 2}));
+  EXPECT_FALSE(architecture.isEdgeConnected({2, 1}));
+  EXPECT_TRUE(architecture.isEdgeConnected({2, 1}, false));
+  EXPECT_TRUE(architecture.isEdgeConnected({69, 70}));
+  EXPECT_FALSE(architecture.isEdgeConnected({70, 69}));
+  EXPECT_FALSE(architecture.isEdgeConnected({0, 2}, false));
+  EXPECT_FALSE(architecture.isEdgeConnected({0, 71}, false));
+
+  const std::vector<std::uint16_t> neighbours{0, 2, 3};
+  EXPECT_EQ(architecture.getNeighbours(1), neighbours);
+  EXPECT_EQ(architecture.getNeighbours(70),
+            std::vector<std::uint16_t>{69});
+  EXPECT_TRUE(architecture.getNeighbours(4).empty());
+}
+
+TEST(TestArchitecture, TeleportationDistances) {
+  Architecture      architecture{};
+  const CouplingMap cm = {{0, 1}, {1, 2}, {2, 3}, {3, 4}};
+  architecture.loadCouplingMap(5, cm);
+  const auto withoutTeleportation = architecture.distance(0, 4);
+
+  architecture.setCurrentTeleportations({{0, 3}});
+  // only connected by teleportation
+  EXPECT_EQ(architecture.distance(0, 3), 7.);
+  EXPECT_EQ(architecture.distance(3, 0), 7.);
+  // shortest path containing an edge of the coupling map in its direction
+  EXPECT_EQ(architecture.distance(0, 4), 7.);
+  EXPECT_EQ(architecture.distance(1, 3), 7.);
+  // shortest paths only using edges of the coupling map in reverse direction
+  EXPECT_EQ(architecture.distance(1, 0), 4.);
+  EXPECT_EQ(architecture.distance(4, 2), 11.);
+
+  architecture.setCurrentTeleportations({{1, 4}});
+  EXPECT_EQ(architecture.distance(0, 4), 7.);
+  EXPECT_EQ(architecture.distance(4, 0), 11.);
+
+  architecture.setCurrentTeleportations({});
+  EXPECT_EQ(architecture.distance(0, 4), withoutTeleportation);
+}
+
+TEST(TestArchitecture, FlatDistanceTable) {
+  Architecture architecture{};
+  architecture.loadCouplingMap(AvailableArchitecture::IbmqTokyo);
+  const auto& table = architecture.getDistanceTable();
+  for (std::uint16_t i = 0; i < architecture.getNqubits(); ++i) {
+    const auto* row = architecture.getDistanceRow(i);
+    for (std::uint16_t j = 0; j < architecture.getNqubits(); ++j) {
+      EXPECT_EQ(architecture.distance(i, j), table.at(i).at(j));
+      EXPECT_EQ(static_cast<double>(row[j]), table.at(i).at(j));
+    }
+  }
+
+  // the flat table follows the distance table of the current teleportations
+  architecture.setCurrentTeleportations({{0, 19}});
+  EXPECT_EQ(architecture.distance(0, 19), 7.);
+  EXPECT_EQ(architecture.getDistanceRow(19)[0], 7.F);
+  architecture.setCurrentTeleportations({});
+  EXPECT_EQ(architecture.distance(0, 19), table.at(0).at(19));
+
+  // reloading the coupling map rebuilds the table for the new size
+  architecture.loadCouplingMap(3, {{0, 1}, {1, 2}});
+  EXPECT_EQ(architecture.distance(0, 1), 0.);
+  EXPECT_EQ(architecture.distance(0, 2),
+            architecture.getDistanceTable().at(0).at(2));
+}
+
 TEST(TestArchitecture, opTypeFromString) {
   Architecture arch{2, {{0, 1}}};
   auto&        props = arch.getProperties();
@@ -6,6 +6,9 @@
 #include "heuristic/HeuristicMapper.hpp"
 
 #include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
 #include <stack>
 
 class HeuristicTest5Q : public testing::TestWithParam<std::string> {
@@ -85,6 +88,725 @@ TEST(Functionality, NodeCostCalculation) {
               tolerance);
 }
 
+TEST(Functionality, NodeIncrementalHeuristicCost) {
+  const double               tolerance = 1e-6;
+  const CouplingMap          cm = {{0, 1}, {1, 2}, {3, 1}, {4, 3}, {2, 5}};
+  Architecture               arch{6, cm};
+  const TwoQubitMultiplicity multiplicity = {
+      {{0, 1}, {5, 2}}, {{2, 3}, {0, 1}}, {{1, 4}, {1, 1}}, {{0, 3}, {1, 0}}};
+  const auto index = HeuristicMapper::createMultiplicityIndex(multiplicity);
+  const std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits = {4, 3, 1,
+                                                              2, 0, -1};
+  const std::array<std::int16_t, MAX_DEVICE_QUBITS> locations = {4, 2, 3, 1, 0};
+  const std::vector<Edge> swaps = {{3, 4}, {1, 2}, {2, 5}, {0, 1},
+                                   {1, 3}, {2, 5}, {3, 4}, {1, 2}};
+
+  for (const bool admissible : {true, false}) {
+    HeuristicMapper::Node node(qubits, locations);
+    node.updateHeuristicCost(arch, multiplicity, admissible);
+    for (const auto& swap : swaps) {
+      auto child = node.createChild(node.getSwapChain());
+      child.applySWAP(swap, arch);
+      child.updateHeuristicCostAfterSwap(arch, multiplicity, index, node, swap,
+                                         admissible);
+      node = child;
+
+      HeuristicMapper::Node reference(node.qubits, node.locations);
+      reference.updateHeuristicCost(arch, multiplicity, admissible);
+      EXPECT_NEAR(node.costHeur, reference.costHeur, tolerance);
+      EXPECT_EQ(node.done, reference.done);
+      EXPECT_EQ(node.nonAdjacentPairs, reference.nonAdjacentPairs);
+    }
+  }
+}
+
+TEST(Functionality, BatchSwapScoring) {
+  const double               tolerance = 1e-6;
+  const CouplingMap          cm = {{0, 1}, {1, 2}, {3, 1}, {4, 3}, {2, 5}};
+  Architecture               arch{6, cm};
+  const TwoQubitMultiplicity multiplicity = {
+      {{0, 1}, {5, 2}}, {{2, 3}, {0, 1}}, {{1, 4}, {1, 1}}, {{0, 3}, {1, 0}}};
+  const auto index = HeuristicMapper::createMultiplicityIndex(multiplicity);
+  const std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits = {4, 3, 1,
+                                                              2, 0, -1};
+  const std::array<std::int16_t, MAX_DEVICE_QUBITS> locations = {4, 2, 3, 1, 0};
+  const std::vector<Edge> swaps(cm.begin(), cm.end());
+
+  for (const bool admissible : {true, false}) {
+    HeuristicMapper::Node node(qubits, locations);
+    node.updateHeuristicCost(arch, multiplicity, admissible);
+    const auto scores = node.scoreSwaps(arch, index, swaps, admissible);
+    ASSERT_EQ(scores.size(), swaps.size());
+    for (std::size_t i = 0; i < swaps.size(); ++i) {
+      auto child = node.createChild(node.getSwapChain());
+      child.applySWAP(swaps[i], arch);
+      child.applySwapScore(scores[i], arch, multiplicity, admissible);
+
+      HeuristicMapper::Node reference(child.qubits, child.locations);
+      reference.updateHeuristicCost(arch, multiplicity, admissible);
+      EXPECT_NEAR(child.costHeur, reference.costHeur, tolerance);
+      EXPECT_EQ(child.done, reference.done);
+      EXPECT_EQ(child.nonAdjacentPairs, reference.nonAdjacentPairs);
+    }
+  }
+}
+
+TEST(Functionality, SwapScoreBatchKernels) {
+  if (!SwapScoreBatch::VECTORIZED) {
+    GTEST_SKIP() << "the AVX2 kernel is not available on this machine";
+  }
+  // the vectorized kernel agrees with the portable one
+  Architecture tokyo{};
+  tokyo.loadCouplingMap(AvailableArchitecture::IbmqTokyo);
+  std::mt19937                                 mt(42);
+  std::uniform_int_distribution<std::uint16_t> location(
+      0, tokyo.getNqubits() - 1);
+  std::uniform_int_distribution<std::uint16_t> gates(0, 3);
+  SwapScoreBatch                               batch{};
+  for (std::size_t i = 0; i < 23; ++i) {
+    batch.add(tokyo.getNqubits(), location(mt), location(mt), location(mt),
+              location(mt), {gates(mt), gates(mt)});
+  }
+  for (const bool admissible : {true, false}) {
+    batch.evaluatePortable(tokyo.getDistanceRow(0), admissible);
+    std::vector<std::pair<double, double>> expected{};
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      expected.emplace_back(batch.oldCost(i), batch.newCost(i));
+    }
+    batch.evaluate(tokyo.getDistanceRow(0), admissible);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      EXPECT_EQ(batch.oldCost(i), expected[i].first);
+      EXPECT_EQ(batch.newCost(i), expected[i].second);
+    }
+  }
+}
+
+TEST(Functionality, NodeSwapChain) {
+  const CouplingMap cm = {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3}, {3, 2}};
+  Architecture      arch{4, cm};
+
+  HeuristicMapper::Node root({0, 1, 2, 3}, {0, 1, 2, 3});
+  EXPECT_TRUE(root.getSwaps().empty());
+  EXPECT_EQ(root.getSwapChain(), nullptr);
+
+  HeuristicMapper::Node parent(root.qubits, root.locations,
+                               root.getSwapChain(), root.costFixed, 1);
+  parent.applySWAP({0, 1}, arch);
+
+  // all children of a node share the same record of the parent's swaps
+  const auto            parentSwaps = parent.getSwapChain();
+  HeuristicMapper::Node child1(parent.qubits, parent.locations, parentSwaps,
+                               parent.costFixed, 2);
+  HeuristicMapper::Node child2(parent.qubits, parent.locations, parentSwaps,
+                               parent.costFixed, 2);
+  child1.applySWAP({1, 2}, arch);
+  child2.applySWAP({2, 3}, arch);
+  child2.applySWAP({1, 2}, arch);
+  EXPECT_EQ(child1.previousSwaps, child2.previousSwaps->previous);
+
+  const auto swaps1 = child1.getSwaps();
+  ASSERT_EQ(swaps1.size(), 2);
+  EXPECT_EQ(swaps1[0].first, 0);
+  EXPECT_EQ(swaps1[0].second, 1);
+  EXPECT_EQ(swaps1[1].first, 1);
+  EXPECT_EQ(swaps1[1].second, 2);
+
+  const auto swaps2 = child2.getSwaps();
+  ASSERT_EQ(swaps2.size(), 3);
+  EXPECT_EQ(swaps2[0].first, 0);
+  EXPECT_EQ(swaps2[1].first, 2);
+  EXPECT_EQ(swaps2[2].first, 1);
+  EXPECT_EQ(parent.getSwaps().size(), 1);
+
+  child2.recalculateFixedCost(arch);
+  EXPECT_EQ(child2.costFixed, 3 * COST_BIDIRECTIONAL_SWAP);
+}
+
+TEST(Functionality, NodeZobristHash) {
+  const CouplingMap cm = {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3}, {3, 2}};
+  Architecture      arch{4, cm};
+
+  std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits{};
+  std::array<std::int16_t, MAX_DEVICE_QUBITS> locations{};
+  qubits.fill(DEFAULT_POSITION);
+  locations.fill(DEFAULT_POSITION);
+  for (std::int16_t i = 0; i < 3; ++i) {
+    qubits.at(static_cast<std::size_t>(i))    = i;
+    locations.at(static_cast<std::size_t>(i)) = i;
+  }
+  const HeuristicMapper::Node root(qubits, locations);
+
+  // the same mapping reached by different swap sequences yields the same hash
+  auto child1 = root.createChild(root.getSwapChain());
+  child1.applySWAP({0, 1}, arch);
+  child1.applySWAP({1, 2}, arch);
+  child1.applySWAP({0, 1}, arch);
+  auto child2 = root.createChild(root.getSwapChain());
+  child2.applySWAP({1, 2}, arch);
+  child2.applySWAP({0, 1}, arch);
+  child2.applySWAP({1, 2}, arch);
+  EXPECT_EQ(child1.qubits, child2.qubits);
+  EXPECT_EQ(child1.hash, child2.hash);
+  EXPECT_TRUE(child1 == child2);
+  EXPECT_EQ(HeuristicMapper::NodeHash()(child1),
+            HeuristicMapper::NodeHash()(child2));
+
+  // incremental updates (including swaps with unmapped qubits) are consistent
+  // with recalculating the hash from scratch
+  child1.applySWAP({2, 3}, arch);
+  const auto incremental = child1.hash;
+  child1.recalculateHash();
+  EXPECT_EQ(incremental, child1.hash);
+  EXPECT_NE(child1.hash, child2.hash);
+  EXPECT_FALSE(child1 == child2);
+}
+
+TEST(Functionality, IndexedPriorityQueue) {
+  // elements are (key, cost) pairs; elements are unique by their key
+  using Element = std::pair<int, int>;
+  struct CostCompare {
+    bool operator()(const Element& x, const Element& y) const {
+      return x.second > y.second;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Element& e) const {
+      return std::hash<int>{}(e.first);
+    }
+  };
+  struct KeyEqual {
+    bool operator()(const Element& x, const Element& y) const {
+      return x.first == y.first;
+    }
+  };
+  IndexedPriorityQueue<Element, CostCompare, KeyHash, KeyEqual, 3> queue{};
+
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_TRUE(queue.push({i, 100 + i}));
+  }
+  EXPECT_EQ(queue.size(), 20);
+  // more expensive duplicates are rejected
+  EXPECT_FALSE(queue.push({5, 200}));
+  EXPECT_FALSE(queue.push({5, 105}));
+  // cheaper duplicates replace the existing element (decrease-key)
+  EXPECT_TRUE(queue.push({15, 50}));
+  EXPECT_EQ(queue.size(), 20);
+  EXPECT_EQ(queue.top(), Element(15, 50));
+  queue.pop();
+  // popped elements may be inserted again
+  EXPECT_TRUE(queue.push({15, 300}));
+
+  std::vector<int> costs{};
+  while (!queue.empty()) {
+    costs.emplace_back(queue.top().second);
+    queue.pop();
+  }
+  EXPECT_EQ(costs.size(), 20);
+  EXPECT_TRUE(std::is_sorted(costs.begin(), costs.end()));
+  EXPECT_EQ(costs.back(), 300);
+
+  queue.push({1, 1});
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+
+  // truncating keeps the best elements and releases the memory of the others
+  for (int i = 0; i < 100; ++i) {
+    queue.push({i, (i * 37) % 100});
+  }
+  const auto usage = queue.memoryUsage();
+  EXPECT_GE(usage, 100 * sizeof(Element));
+  queue.truncate(10);
+  EXPECT_EQ(queue.size(), 10);
+  EXPECT_LT(queue.memoryUsage(), usage);
+  // the truncated elements are no longer considered duplicates
+  EXPECT_TRUE(queue.push({(50 * 73) % 100, 50}));
+  for (int cost = 0; cost < 10; ++cost) {
+    EXPECT_EQ(queue.top().second, cost);
+    queue.pop();
+  }
+  EXPECT_EQ(queue.top(), Element((50 * 73) % 100, 50));
+}
+
+TEST(Functionality, SearchArena) {
+  SearchArena arena{};
+  std::vector<void*> first{};
+  for (std::size_t i = 0; i < 1000; ++i) {
+    auto* ptr = arena.allocate(48, 16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 16, 0);
+    first.emplace_back(ptr);
+  }
+  // a large allocation exceeding the default block size
+  EXPECT_NE(arena.allocate(4 * SearchArena::DEFAULT_BLOCK_SIZE, 64), nullptr);
+  const auto capacity = arena.capacity();
+  EXPECT_GE(capacity, 4 * SearchArena::DEFAULT_BLOCK_SIZE);
+
+  // after a reset the same memory is handed out again
+  arena.reset();
+  for (std::size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(arena.allocate(48, 16), first[i]);
+  }
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // the hash index of a queue can be backed by the arena
+  arena.reset();
+  IndexedPriorityQueue<int> queue{&arena};
+  for (int i = 0; i < 100; ++i) {
+    queue.push(i);
+  }
+  EXPECT_EQ(queue.top(), 0);
+  queue.clear();
+  arena.reset();
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(Functionality, SearchArenaReleasing) {
+  SearchArena arena{};
+  // fills a queue backed by the arena and prunes it again in each round
+  const auto fillAndPrune = [&arena](const bool releasing, const int rounds) {
+    arena.reset(releasing);
+    IndexedPriorityQueue<int> queue{&arena};
+    for (int round = 0; round < rounds; ++round) {
+      for (int i = 0; i < 1000; ++i) {
+        queue.push(round * 1000 + i);
+      }
+      queue.truncate(100);
+    }
+    EXPECT_EQ(queue.size(), 100);
+    return arena.peakUsage();
+  };
+
+  // without releasing, the memory of pruned hash indices is kept
+  const auto monotonicPeak = fillAndPrune(false, 20);
+  EXPECT_GT(monotonicPeak, 10 * fillAndPrune(false, 1));
+
+  // while releasing, the usage stays bounded by the size of the queue
+  const auto capacity = arena.capacity();
+  const auto peak     = fillAndPrune(true, 20);
+  EXPECT_LE(peak, 2 * fillAndPrune(true, 1));
+  EXPECT_LT(peak, monotonicPeak);
+  EXPECT_EQ(arena.capacity(), capacity);
+  arena.reset();
+}
+
+TEST(Functionality, MemoryLimit) {
+  Architecture arch{};
+  arch.loadCouplingMap(AvailableArchitecture::IbmqTokyo);
+  qc::QuantumComputation qc{};
+  qc.import("../examples/qft_16.qasm");
+
+  HeuristicMapper unlimitedMapper(qc, arch);
+  auto            config = Configuration{};
+  config.debug           = true;
+  unlimitedMapper.map(config);
+  EXPECT_EQ(unlimitedMapper.getResults().heuristicBenchmark.prunedNodes, 0);
+
+  for (const auto searchAlgorithm :
+       {SearchAlgorithm::AStar, SearchAlgorithm::HDAStar}) {
+    config.searchAlgorithm = searchAlgorithm;
+    // the search nodes for IBMQ Tokyo (20 qubits) hold up to 32 qubits
+    config.memoryLimit = 8 * sizeof(BasicHeuristicMapper<32>::Node);
+    HeuristicMapper limitedMapper(qc, arch);
+    limitedMapper.map(config);
+    const auto& limitedResults = limitedMapper.getResults();
+    EXPECT_GT(limitedResults.heuristicBenchmark.prunedNodes, 0);
+    // the mapping still completes (possibly with more swaps)
+    EXPECT_GE(limitedResults.output.cnots, limitedResults.input.cnots);
+  }
+
+  // partial expansion keeps most children out of the open list
+  config.searchAlgorithm = SearchAlgorithm::PEAStar;
+  HeuristicMapper partialExpansionMapper(qc, arch);
+  partialExpansionMapper.map(config);
+  const auto& partialExpansionResults = partialExpansionMapper.getResults();
+  EXPECT_EQ(partialExpansionResults.heuristicBenchmark.prunedNodes, 0);
+  EXPECT_EQ(partialExpansionResults.output.swaps,
+            unlimitedMapper.getResults().output.swaps);
+}
+
+TEST(Functionality, MemoryLimitFewNodes) {
+  Architecture arch{};
+  arch.loadCouplingMap(5, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {1, 3}, {3, 1},
+                           {3, 4}, {4, 3}});
+  std::mt19937                             mt(0);
+  std::uniform_int_distribution<qc::Qubit> qubit(0, 4);
+  qc::QuantumComputation                   qc{5};
+  for (std::size_t i = 0; i < 30; ++i) {
+    const auto control = qubit(mt);
+    auto       target  = qubit(mt);
+    while (target == control) {
+      target = qubit(mt);
+    }
+    qc.x(target, qc::Control{control});
+  }
+
+  // with room for only a few nodes, pruning may drop every node leading to a
+  // goal, so that the layer has to be mapped by IDA* instead
+  auto config     = Configuration{};
+  config.layering = Layering::DisjointQubits;
+  config.debug    = true;
+  for (const auto searchAlgorithm :
+       {SearchAlgorithm::AStar, SearchAlgorithm::HDAStar,
+        SearchAlgorithm::PEAStar}) {
+    for (const std::size_t nodes : {2U, 4U, 8U}) {
+      config.searchAlgorithm = searchAlgorithm;
+      config.memoryLimit     = nodes * sizeof(BasicHeuristicMapper<16>::Node);
+      HeuristicMapper mapper(qc, arch);
+      // the mapping is checked against the coupling map while it is built
+      EXPECT_NO_THROW(mapper.map(config));
+      const auto& results = mapper.getResults();
+      EXPECT_GT(results.heuristicBenchmark.prunedNodes, 0);
+      EXPECT_GE(results.output.cnots, results.input.cnots);
+      EXPECT_GT(results.output.swaps, 0U);
+    }
+  }
+}
+
+TEST(Functionality, NodeCapacity) {
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(5), 16);
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(16), 16);
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(20), 32);
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(129), 256);
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(MAX_DEVICE_QUBITS),
+            MAX_DEVICE_QUBITS);
+  EXPECT_EQ(HeuristicMapper::nodeCapacity(MAX_DEVICE_QUBITS + 1), 0);
+  EXPECT_LT(sizeof(BasicHeuristicMapper<16>::Node),
+            sizeof(BasicHeuristicMapper<128>::Node));
+
+  // linear architecture exceeding 128 qubits
+  constexpr std::uint16_t nqubits = 150;
+  CouplingMap             cm{};
+  for (std::uint16_t i = 0; i + 1 < nqubits; ++i) {
+    cm.emplace(i, i + 1);
+    cm.emplace(i + 1, i);
+  }
+  Architecture arch{};
+  arch.loadCouplingMap(nqubits, cm);
+
+  qc::QuantumComputation qc{nqubits};
+  for (qc::Qubit i = 0; i < nqubits; ++i) {
+    qc.h(i);
+  }
+  for (qc::Qubit i = 0; i + 5 < nqubits; i += 6) {
+    qc.x(i + 5, qc::Control{i});
+  }
+
+  HeuristicMapper mapper(qc, arch);
+  auto            config = Configuration{};
+  config.initialLayout   = InitialLayout::Identity;
+  mapper.map(config);
+  const auto& results = mapper.getResults();
+  EXPECT_EQ(results.output.qubits, nqubits);
+  EXPECT_GT(results.output.swaps, 0U);
+  EXPECT_FALSE(results.timeout);
+}
+
+TEST(Functionality, PreprocessingOnce) {
+  using namespace qc::literals;
+  // q[1] is only measured, so that it is only idle once the final
+  // measurements have been removed
+  qc::QuantumComputation qc{3U, 3U};
+  qc.x(2, 0_pc);
+  qc.measure(1, 1);
+
+  Architecture arch{};
+  arch.loadCouplingMap(AvailableArchitecture::IbmqLondon);
+
+  HeuristicMapper mapper(qc, arch);
+  mapper.map(Configuration{});
+  EXPECT_EQ(mapper.getResults().input.qubits, 3U);
+  EXPECT_EQ(mapper.getResults().input.layers, 1U);
+
+  // the layers are kept by repeated runs
+  mapper.map(Configuration{});
+  EXPECT_EQ(mapper.getResults().input.qubits, 3U);
+  EXPECT_EQ(mapper.getResults().input.layers, 1U);
+}
+
+class HeuristicTestGrid3x3 : public testing::Test {
+protected:
+  /*
+    0---1---2
+    |   |   |
+    3---4---5
+    |   |   |
+    6---7---8
+  */
+  Architecture architecture{};
+  // the gates need swaps on disjoint edges, which can be applied in any order
+  qc::QuantumComputation qc{9};
+  Configuration          settings{};
+
+  void SetUp() override {
+    CouplingMap cm{};
+    for (std::uint16_t i = 0; i < 9; ++i) {
+      if (i % 3 != 2) {
+        cm.insert({i, i + 1});
+        cm.insert({i + 1, i});
+      }
+      if (i < 6) {
+        cm.insert({i, i + 3});
+        cm.insert({i + 3, i});
+      }
+    }
+    architecture.loadCouplingMap(9, cm);
+
+    for (qc::Qubit q = 0; q < 9; ++q) {
+      qc.h(q);
+    }
+    qc.x(8, qc::Control{0});
+    qc.x(6, qc::Control{2});
+    qc.x(7, qc::Control{1});
+
+    settings.layering                 = Layering::DisjointQubits;
+    settings.initialLayout            = InitialLayout::Identity;
+    settings.preMappingOptimizations  = false;
+    settings.postMappingOptimizations = false;
+    settings.lookahead                = false;
+    settings.debug                    = true;
+  }
+};
+
+TEST_F(HeuristicTestGrid3x3, ClosedSet) {
+  // without the closed set 203 (admissible) and 42 (non-admissible) nodes are
+  // expanded, as mappings are regenerated by swapping in a different order
+  double effectiveBranchingFactor = 0.;
+  for (const auto& [admissible, expandedNodes, swaps] :
+       {std::tuple{true, 154U, 5U}, std::tuple{false, 27U, 6U}}) {
+    settings.admissibleHeuristic = admissible;
+    HeuristicMapper mapper(qc, architecture);
+    mapper.map(settings);
+    const auto& results = mapper.getResults();
+    EXPECT_EQ(results.output.swaps, swaps);
+    EXPECT_EQ(results.heuristicBenchmark.expandedNodes, expandedNodes);
+    EXPECT_EQ(results.heuristicBenchmark.reExpandedNodes, 0U);
+    if (admissible) {
+      effectiveBranchingFactor =
+          results.heuristicBenchmark.effectiveBranchingFactor;
+    }
+  }
+
+  // the result is still optimal
+  settings.admissibleHeuristic = true;
+  settings.searchAlgorithm     = SearchAlgorithm::IDAStar;
+  HeuristicMapper idaStarMapper(qc, architecture);
+  idaStarMapper.map(settings);
+  EXPECT_EQ(idaStarMapper.getResults().output.swaps, 5U);
+
+  // considering only one order of swaps on disjoint edges avoids generating
+  // most of these mappings in the first place
+  settings.searchAlgorithm     = SearchAlgorithm::AStar;
+  settings.pruneCommutingSwaps = true;
+  HeuristicMapper pruningMapper(qc, architecture);
+  pruningMapper.map(settings);
+  const auto& pruningResults = pruningMapper.getResults();
+  EXPECT_EQ(pruningResults.output.swaps, 5U);
+  EXPECT_EQ(pruningResults.heuristicBenchmark.expandedNodes, 117U);
+  EXPECT_LT(pruningResults.heuristicBenchmark.effectiveBranchingFactor,
+            effectiveBranchingFactor);
+}
+
+TEST_F(HeuristicTestGrid3x3, SwapCountBound) {
+  // the pairs need 3, 3 and 1 swaps on their own, but as each swap moves only
+  // two qubits, at least 4 swaps are needed for all of them
+  const TwoQubitMultiplicity multiplicity{
+      {{0, 8}, {1, 0}}, {{2, 6}, {1, 0}}, {{1, 7}, {1, 0}}};
+  HeuristicMapper::Node node{};
+  for (std::int16_t q = 0; q < 9; ++q) {
+    node.qubits.at(static_cast<std::size_t>(q))    = q;
+    node.locations.at(static_cast<std::size_t>(q)) = q;
+  }
+  EXPECT_EQ(node.swapCountLowerBound(architecture, multiplicity), 4U);
+  node.updateHeuristicCost(architecture, multiplicity, true);
+  EXPECT_EQ(node.costHeur, 3. * COST_BIDIRECTIONAL_SWAP);
+  node.updateHeuristicCost(architecture, multiplicity, true, true);
+  EXPECT_EQ(node.costHeur, 4. * COST_BIDIRECTIONAL_SWAP);
+
+  settings.swapCountBound = true;
+
+  // the result is still optimal (see the ClosedSet test), but far fewer nodes
+  // are expanded
+  HeuristicMapper mapper(qc, architecture);
+  mapper.map(settings);
+  const auto& results = mapper.getResults();
+  EXPECT_EQ(results.output.swaps, 5U);
+  EXPECT_EQ(results.heuristicBenchmark.expandedNodes, 92U);
+}
+
+TEST_F(HeuristicTestGrid3x3, PatternDatabase) {
+  const auto directory =
+      (std::filesystem::temp_directory_path() /
+       ("qmap_pattern_databases_" + std::to_string(std::random_device{}())))
+          .string();
+  std::filesystem::remove_all(directory);
+  const auto database = PatternDatabase::loadOrCreate(architecture, directory);
+  EXPECT_TRUE(database->matches(architecture));
+  EXPECT_TRUE(database->hasTwoPairTable());
+  EXPECT_EQ(database->pairSwaps(0, 1), 0U);
+  EXPECT_EQ(database->pairSwaps(1, 7), 1U);
+  EXPECT_EQ(database->pairSwaps(0, 8), 3U);
+  // swapping 0 and 1 brings both pairs together
+  EXPECT_EQ(database->twoPairSwaps(0, 2, 1, 3), 1U);
+  EXPECT_EQ(database->twoPairSwaps(0, 2, 6, 8), 2U);
+  // the pairs need 3 swaps each, but one swap may move a qubit of both
+  EXPECT_EQ(database->twoPairSwaps(0, 8, 2, 6), 5U);
+
+  // the database is stored under the hash of the coupling map
+  const auto file = std::filesystem::path(directory) /
+                    PatternDatabase::filename(architecture);
+  ASSERT_TRUE(std::filesystem::exists(file));
+  const auto loaded = PatternDatabase::load(file.string());
+  EXPECT_EQ(loaded.getCouplingMapHash(), database->getCouplingMapHash());
+  EXPECT_EQ(loaded.twoPairSwaps(0, 8, 2, 6), 5U);
+
+  Architecture line{};
+  line.loadCouplingMap(9, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 6},
+                           {6, 7}, {7, 8}});
+  EXPECT_FALSE(loaded.matches(line));
+  EXPECT_NE(PatternDatabase::filename(line),
+            PatternDatabase::filename(architecture));
+  EXPECT_THROW(static_cast<void>(PatternDatabase::load(directory + "/none")),
+               QMAPException);
+
+  // truncated files are rebuilt
+  std::filesystem::resize_file(file, std::filesystem::file_size(file) / 2);
+  EXPECT_THROW(static_cast<void>(PatternDatabase::load(file.string())),
+               QMAPException);
+  const auto rebuilt = PatternDatabase::loadOrCreate(architecture, directory);
+  EXPECT_EQ(rebuilt->twoPairSwaps(0, 8, 2, 6), 5U);
+  EXPECT_EQ(PatternDatabase::load(file.string()).twoPairSwaps(0, 8, 2, 6), 5U);
+
+  // the size is checked before the tables are allocated
+  {
+    std::fstream fs(file, std::ios::binary | std::ios::in | std::ios::out);
+    fs.seekp(8); // after the magic number
+    const std::uint16_t nqubits = MAX_DEVICE_QUBITS + 1;
+    fs.write(reinterpret_cast<const char*>(&nqubits), // NOLINT
+             sizeof(nqubits));
+  }
+  EXPECT_THROW(static_cast<void>(PatternDatabase::load(file.string())),
+               QMAPException);
+
+  settings.usePatternDatabase       = true;
+  settings.patternDatabaseDirectory = directory;
+
+  // the result is still optimal, with fewer nodes expanded than with the swap
+  // count bound based on the distance table (see the SwapCountBound test)
+  HeuristicMapper mapper(qc, architecture);
+  mapper.map(settings);
+  const auto& results = mapper.getResults();
+  EXPECT_EQ(results.output.swaps, 5U);
+  EXPECT_EQ(results.heuristicBenchmark.expandedNodes, 62U);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(HeuristicTestGrid3x3, LayerCache) {
+  // the same gates are repeated, so that some layers are solved from the same
+  // positions again
+  qc::QuantumComputation repeated{9};
+  for (qc::Qubit q = 0; q < 9; ++q) {
+    repeated.h(q);
+  }
+  for (std::size_t i = 0; i < 6; ++i) {
+    repeated.x(8, qc::Control{0});
+    repeated.x(6, qc::Control{2});
+    repeated.x(0, qc::Control{2});
+    repeated.x(6, qc::Control{8});
+  }
+  settings.layering = Layering::IndividualGates;
+
+  HeuristicMapper reference(repeated, architecture);
+  reference.map(settings);
+  const auto& referenceResults = reference.getResults();
+  EXPECT_EQ(referenceResults.heuristicBenchmark.layerCacheHits, 0U);
+  EXPECT_EQ(referenceResults.heuristicBenchmark.layerCacheMisses, 0U);
+
+  // replayed layers are solved with the same cost as by a search, but not
+  // necessarily with the same swaps
+  settings.cacheLayerSolutions = true;
+  HeuristicMapper mapper(repeated, architecture);
+  mapper.map(settings);
+  const auto& results = mapper.getResults();
+  const auto  layers  = results.input.layers;
+  EXPECT_GT(results.heuristicBenchmark.layerCacheHits, 0U);
+  EXPECT_EQ(results.heuristicBenchmark.layerCacheHits +
+                results.heuristicBenchmark.layerCacheMisses,
+            layers);
+  EXPECT_EQ(results.json()["statistics"]["benchmark"]["layer_cache_hits"],
+            results.heuristicBenchmark.layerCacheHits);
+
+  // later mappers sharing the cache replay all layers
+  HeuristicMapper sharingMapper(repeated, architecture);
+  sharingMapper.setLayerCache(mapper.getLayerCache());
+  sharingMapper.map(settings);
+  const auto& sharingResults = sharingMapper.getResults();
+  EXPECT_EQ(sharingResults.heuristicBenchmark.layerCacheHits, layers);
+  EXPECT_EQ(sharingResults.heuristicBenchmark.expandedNodes, 0U);
+  EXPECT_EQ(sharingResults.output.swaps, results.output.swaps);
+
+  // settings which do not affect the swaps keep the cache
+  settings.nThreads = 2;
+  HeuristicMapper threadsMapper(repeated, architecture);
+  threadsMapper.setLayerCache(mapper.getLayerCache());
+  threadsMapper.map(settings);
+  EXPECT_EQ(threadsMapper.getResults().heuristicBenchmark.layerCacheHits,
+            layers);
+
+  // solutions of searches which dropped nodes due to the memory limit are not
+  // cached
+  settings.memoryLimit = 4 * sizeof(BasicHeuristicMapper<16>::Node);
+  HeuristicMapper limitedMapper(repeated, architecture);
+  limitedMapper.setLayerCache(std::make_shared<LayerCache>());
+  limitedMapper.map(settings);
+  EXPECT_GT(limitedMapper.getResults().heuristicBenchmark.prunedNodes, 0U);
+  settings.memoryLimit = 0;
+  HeuristicMapper unlimitedMapper(repeated, architecture);
+  unlimitedMapper.setLayerCache(limitedMapper.getLayerCache());
+  unlimitedMapper.map(settings);
+  const auto& unlimitedResults = unlimitedMapper.getResults();
+  EXPECT_GT(unlimitedResults.heuristicBenchmark.layerCacheMisses, 0U);
+  EXPECT_EQ(unlimitedResults.output.swaps, results.output.swaps);
+
+  // a different configuration invalidates the cache
+  settings.admissibleHeuristic = false;
+  HeuristicMapper nonAdmissibleMapper(repeated, architecture);
+  nonAdmissibleMapper.setLayerCache(mapper.getLayerCache());
+  nonAdmissibleMapper.map(settings);
+  const auto& nonAdmissibleResults = nonAdmissibleMapper.getResults();
+  EXPECT_LT(nonAdmissibleResults.heuristicBenchmark.layerCacheHits, layers);
+  EXPECT_EQ(nonAdmissibleResults.heuristicBenchmark.layerCacheHits +
+                nonAdmissibleResults.heuristicBenchmark.layerCacheMisses,
+            layers);
+}
+
+TEST(Functionality, Layering) {
+  using namespace qc::literals;
+  qc::QuantumComputation qc{4U};
+  qc.x(0);
+  qc.x(1, 0_pc);
+  qc.x(0, 1_pc);
+  qc.x(1);
+  qc.x(3, 2_pc);
+  qc.x(2, 0_pc);
+  qc.x(3);
+
+  Architecture arch{};
+  arch.loadCouplingMap(AvailableArchitecture::IbmqLondon);
+
+  const std::vector<std::pair<Layering, std::size_t>> expectedLayers = {
+      {Layering::IndividualGates, 7U},
+      {Layering::DisjointQubits, 4U},
+      {Layering::Disjoint2qBlocks, 3U}};
+  for (const auto& [layering, layers] : expectedLayers) {
+    HeuristicMapper mapper(qc, arch);
+    Configuration   settings{};
+    settings.layering = layering;
+    mapper.map(settings);
+    EXPECT_EQ(mapper.getResults().input.layers, layers) << toString(layering);
+  }
+}
+
 TEST(Functionality, HeuristicBenchmark) {
   /*
       3
@@ -211,6 +933,125 @@ TEST(Functionality, NoMeasurmentsAdded) {
   EXPECT_NE(qcMapped.back()->getType(), qc::Measure);
 }
 
+class HeuristicTestTokyoDistantGates : public testing::Test {
+protected:
+  Architecture architecture{};
+  // a single layer of distant gates (after an initial layer, which is mapped
+  // without swaps)
+  qc::QuantumComputation qc{20U};
+  Configuration          settings{};
+
+  void SetUp() override {
+    using namespace qc::literals;
+    architecture.loadCouplingMap(AvailableArchitecture::IbmqTokyo);
+
+    for (qc::Qubit i = 0; i < 20; ++i) {
+      qc.h(i);
+    }
+    qc.x(19, 0_pc);
+    qc.x(14, 3_pc);
+    qc.x(8, 16_pc);
+
+    settings.layering            = Layering::DisjointQubits;
+    settings.initialLayout       = InitialLayout::Identity;
+    settings.lookahead           = false;
+    settings.admissibleHeuristic = true;
+  }
+};
+
+TEST_F(HeuristicTestTokyoDistantGates, SearchAlgorithmsSameCost) {
+  HeuristicMapper sequentialMapper(qc, architecture);
+  sequentialMapper.map(settings);
+  const auto& sequentialResults = sequentialMapper.getResults();
+  EXPECT_GT(sequentialResults.output.swaps, 0U);
+
+  const std::vector<std::pair<SearchAlgorithm, std::size_t>> searches = {
+      {SearchAlgorithm::HDAStar, 1U},
+      {SearchAlgorithm::HDAStar, 4U},
+      {SearchAlgorithm::IDAStar, 1U},
+      {SearchAlgorithm::PEAStar, 1U}};
+  for (const auto& [searchAlgorithm, nThreads] : searches) {
+    settings.searchAlgorithm = searchAlgorithm;
+    settings.nThreads        = nThreads;
+    HeuristicMapper mapper(qc, architecture);
+    mapper.map(settings);
+    const auto& mapperResults = mapper.getResults();
+    EXPECT_EQ(mapperResults.output.swaps, sequentialResults.output.swaps);
+    EXPECT_EQ(mapperResults.output.directionReverse,
+              sequentialResults.output.directionReverse);
+  }
+
+  // a tiny transposition table only affects the runtime of IDA*
+  settings.searchAlgorithm = SearchAlgorithm::IDAStar;
+  settings.nThreads        = 1U;
+  settings.memoryLimit     = 1U;
+  HeuristicMapper mapper(qc, architecture);
+  mapper.map(settings);
+  EXPECT_EQ(mapper.getResults().output.swaps, sequentialResults.output.swaps);
+}
+
+TEST_F(HeuristicTestTokyoDistantGates, AnytimeSearch) {
+  HeuristicMapper sequentialMapper(qc, architecture);
+  sequentialMapper.map(settings);
+  const auto& sequentialResults = sequentialMapper.getResults();
+  EXPECT_FALSE(sequentialResults.suboptimalityBound.has_value());
+
+  // without a time budget the weight is decreased until the mapping is optimal
+  settings.searchAlgorithm = SearchAlgorithm::AnytimeAStar;
+  settings.heuristicWeight = 3.;
+  settings.timeout         = 0U;
+  HeuristicMapper anytimeMapper(qc, architecture);
+  anytimeMapper.map(settings);
+  const auto& anytimeResults = anytimeMapper.getResults();
+  EXPECT_EQ(anytimeResults.output.swaps, sequentialResults.output.swaps);
+  ASSERT_TRUE(anytimeResults.suboptimalityBound.has_value());
+  EXPECT_DOUBLE_EQ(*anytimeResults.suboptimalityBound, 1.);
+  EXPECT_FALSE(anytimeResults.timeout);
+  EXPECT_EQ(anytimeResults.json()["statistics"]["suboptimality_bound"], 1.);
+
+  // an exhausted time budget still yields a valid mapping
+  settings.heuristicWeight = 10.;
+  settings.layerTimeout    = 1U;
+  HeuristicMapper budgetMapper(qc, architecture);
+  budgetMapper.map(settings);
+  const auto& budgetResults = budgetMapper.getResults();
+  EXPECT_GE(budgetResults.output.swaps, sequentialResults.output.swaps);
+  ASSERT_TRUE(budgetResults.suboptimalityBound.has_value());
+  EXPECT_GE(*budgetResults.suboptimalityBound, 1.);
+}
+
+TEST_F(HeuristicTestTokyoDistantGates, AnytimeSearchWithoutBound) {
+  // the costs of the search do not bound the optimal cost with lookahead or a
+  // non-admissible heuristic
+  settings.searchAlgorithm = SearchAlgorithm::AnytimeAStar;
+  settings.heuristicWeight = 3.;
+  settings.timeout         = 0U;
+  settings.lookahead       = true;
+  HeuristicMapper lookaheadMapper(qc, architecture);
+  lookaheadMapper.map(settings);
+  const auto& lookaheadResults = lookaheadMapper.getResults();
+  EXPECT_GT(lookaheadResults.output.swaps, 0U);
+  EXPECT_FALSE(lookaheadResults.suboptimalityBound.has_value());
+  EXPECT_TRUE(
+      lookaheadResults.json()["statistics"]["suboptimality_bound"].is_null());
+
+  settings.lookahead           = false;
+  settings.admissibleHeuristic = false;
+  HeuristicMapper nonAdmissibleMapper(qc, architecture);
+  nonAdmissibleMapper.map(settings);
+  const auto& nonAdmissibleResults = nonAdmissibleMapper.getResults();
+  EXPECT_GT(nonAdmissibleResults.output.swaps, 0U);
+  EXPECT_FALSE(nonAdmissibleResults.suboptimalityBound.has_value());
+  EXPECT_TRUE(nonAdmissibleResults.json()["statistics"]["suboptimality_bound"]
+                  .is_null());
+
+  // the bound is determined anew by each mapping run
+  settings.admissibleHeuristic = true;
+  nonAdmissibleMapper.map(settings);
+  EXPECT_TRUE(
+      nonAdmissibleMapper.getResults().suboptimalityBound.has_value());
+}
+
 TEST(Functionality, HeuristicAdmissibility) {
   Architecture      architecture{};
   const CouplingMap cm = {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3},
@@ -249,7 +1090,8 @@ TEST(Functionality, HeuristicAdmissibility) {
     --permStack.top();
     const auto perm    = perms[permStack.top()];
     auto       newNode = HeuristicMapper::Node(node.qubits, node.locations,
-                                               node.swaps, node.costFixed);
+                                               node.getSwapChain(),
+                                               node.costFixed);
     newNode.applySWAP(perm, architecture);
     newNode.updateHeuristicCost(architecture, multiplicity, true);
     nodeStack.emplace_back(newNode);
@@ -390,6 +1232,27 @@ TEST_P(HeuristicTest20Q, Dynamic) {
   SUCCEED() << "Mapping successful";
 }
 
+TEST_P(HeuristicTest20Q, MultiThreaded) {
+  Configuration settings{};
+  settings.initialLayout = InitialLayout::Dynamic;
+  tokyoMapper->map(settings);
+  std::stringstream sequentialCircuit{};
+  tokyoMapper->dumpResult(sequentialCircuit, qc::Format::OpenQASM);
+
+  auto parallelMapper = std::make_unique<HeuristicMapper>(qc, arch);
+  settings.nThreads   = 4;
+  parallelMapper->map(settings);
+  std::stringstream parallelCircuit{};
+  parallelMapper->dumpResult(parallelCircuit, qc::Format::OpenQASM);
+
+  const auto& sequentialResults = tokyoMapper->getResults();
+  const auto& parallelResults   = parallelMapper->getResults();
+  EXPECT_EQ(parallelResults.output.swaps, sequentialResults.output.swaps);
+  EXPECT_EQ(parallelResults.heuristicBenchmark.expandedNodes,
+            sequentialResults.heuristicBenchmark.expandedNodes);
+  EXPECT_EQ(parallelCircuit.str(), sequentialCircuit.str());
+}
+
 class HeuristicTest20QTeleport
     : public testing::TestWithParam<std::tuple<std::uint64_t, std::string>> {
 protected: